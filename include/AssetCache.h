@@ -0,0 +1,79 @@
+// AssetCache.h
+///////////////////////////////////////////
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <filesystem>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace game
+{
+    /**
+     * @brief Process-wide cache of the images, textures and fonts read from res/
+     * Every file is read and decoded once per process. preload() decodes files on
+     * background threads while the game starts. A texture is uploaded from its
+     * decoded image the first time it is asked for, on the calling thread, which
+     * needs a GL context. Assets live until the process exits.
+     */
+    class AssetCache
+    {
+    public:
+        static AssetCache& instance();
+
+        AssetCache(const AssetCache&) = delete;
+        AssetCache& operator=(const AssetCache&) = delete;
+
+        /**
+         * @brief starts reading and decoding files in the background (files already cached are skipped)
+         *
+         * @param images image files (also used for textures)
+         * @param fonts font files
+         */
+        void preload(const std::vector<std::filesystem::path>& images, const std::vector<std::filesystem::path>& fonts);
+
+        /**
+         * @brief decoded image (waits for its preload)
+         *
+         * @param path image file
+         * @return const sf::Image* nullptr if it couldn't be loaded
+         */
+        const sf::Image* image(const std::filesystem::path& path);
+
+        /**
+         * @brief GPU texture of an image, uploaded on first use (call from the render thread)
+         *
+         * @param path image file
+         * @return const sf::Texture* nullptr if it couldn't be loaded
+         */
+        const sf::Texture* texture(const std::filesystem::path& path);
+
+        /**
+         * @brief opened font (waits for its preload)
+         *
+         * @param path font file
+         * @return const sf::Font* nullptr if it couldn't be opened
+         */
+        const sf::Font* font(const std::filesystem::path& path);
+
+    private:
+        AssetCache() = default;
+
+        // nullptr once loaded -> the file couldn't be read
+        using ImageFuture = std::shared_future<std::shared_ptr<const sf::Image>>;
+        using FontFuture = std::shared_future<std::shared_ptr<const sf::Font>>;
+
+        // future of an asset, started on a background thread if it isn't cached yet
+        ImageFuture imageFuture(const std::filesystem::path& path);
+        FontFuture fontFuture(const std::filesystem::path& path);
+
+    private:
+        std::mutex m_mutex; // guards the maps, not the assets (they are immutable once loaded)
+        std::map<std::filesystem::path, ImageFuture> m_images;
+        std::map<std::filesystem::path, FontFuture> m_fonts;
+        std::map<std::filesystem::path, std::unique_ptr<sf::Texture>> m_textures; // nullptr -> couldn't be loaded
+    };
+};
@@ -0,0 +1,110 @@
+// BitBoard.h
+///////////////////////////////////////////
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace game
+{
+    // Kernel used to compute neighbour counts in bulk
+    enum class CountKernel : char // 1-byte
+    {
+        best, scalar, avx2
+    };
+
+    /**
+     * @brief Board layout storing mine/revealed/flagged states as row bitmaps (1 bit per tile)
+     * Bit b of word k of a row is column 64 * k + b. Every row is padded with a zero
+     * word on both sides and the board with a zero row above and below, so the
+     * shift-and-add kernels never check edges.
+     */
+    class BitBoard
+    {
+    public:
+        // state stored as one bitmap per plane
+        enum class Plane : char // 1-byte
+        {
+            mines, revealed, flagged
+        };
+
+        // Default Constructor (You have to call reset to set board size)
+        BitBoard();
+
+        BitBoard(uint32_t width, uint32_t height);
+
+        /**
+         * @brief clears every plane and resizes the board
+         *
+         * @param width board width in tiles
+         * @param height board height in tiles
+         */
+        void reset(uint32_t width, uint32_t height);
+
+        void set(Plane plane, uint32_t tileIndex1D, bool value);
+        bool test(Plane plane, uint32_t tileIndex1D) const;
+
+        /**
+         * @brief computes the number of mined neighbours of every tile at once
+         * counts are kept bit-sliced (4 bitmaps, one per bit of the count)
+         *
+         * @param kernel kernel to use, best picks AVX2 when the CPU supports it
+         */
+        void computeCounts(CountKernel kernel = CountKernel::best);
+
+        /**
+         * @brief number of mined neighbours of a tile (call computeCounts first)
+         *
+         * @param tileIndex1D index in 1Dim tiles array
+         * @return uint8_t counter (max: 8)
+         */
+        uint8_t count(uint32_t tileIndex1D) const;
+
+        /**
+         * @brief unpacks all counters to one byte per tile (call computeCounts first)
+         *
+         * @param counts array of width * height bytes (PLEASE MAKE SURE THAT THIS IS ALLOCATED IN MEMORY)
+         */
+        void exportCounts(uint8_t* counts) const;
+
+        // number of tiles set in a plane
+        uint64_t popcount(Plane plane) const;
+
+        // true when every non-mined tile is revealed
+        bool allSafeRevealed() const;
+
+        // true when flags are exactly on the mines
+        bool flagsOnMines() const;
+
+        // true when a mined tile was revealed
+        bool mineRevealed() const;
+
+        uint32_t width() const { return m_width; }
+        uint32_t height() const { return m_height; }
+
+        // true if the CPU can run the AVX2 kernel
+        static bool hasAvx2();
+
+        // kernel that CountKernel::best resolves to on this CPU
+        static CountKernel bestKernel();
+
+    private:
+        // index of the first word of a row (row -1 and row height are the zero padding rows)
+        size_t rowOffset(int64_t row) const { return size_t(row + 1) * m_stride + 1; }
+
+        std::vector<uint64_t>& plane(Plane plane);
+        const std::vector<uint64_t>& plane(Plane plane) const;
+
+    private:
+        std::vector<uint64_t> m_mines;
+        std::vector<uint64_t> m_revealed;
+        std::vector<uint64_t> m_flagged;
+        std::vector<uint64_t> m_counts[4]; // bit-sliced neighbour counts (bit 0 .. bit 3)
+        std::vector<uint64_t> m_validMask; // one row: bits of real columns
+        uint32_t m_width = 0;
+        uint32_t m_height = 0;
+        uint32_t m_words = 0; // words per row holding real columns
+        uint32_t m_stride = 0; // words per row including padding
+    };
+};
@@ -0,0 +1,301 @@
+// Board.h
+///////////////////////////////////////////
+#pragma once
+
+#include <Tile.h>
+#include <TileLayout.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace game
+{
+    // State of a whole game on a board
+    enum class GameStatus : char // 1-byte
+    {
+        notStarted, playing, won, lost
+    };
+
+    // boards with at least this many tiles compute mine counters with BitBoard kernels
+    static const uint32_t bulkCountMinSize = 128u * 128u;
+
+    // boards with at least this many tiles may open big regions with a ParallelFlood
+    static const uint32_t parallelFloodMinSize = 1024u * 1024u;
+    // ... once the flood fill has opened more than size / parallelFloodShare tiles
+    static const uint32_t parallelFloodShare = 16;
+
+    class ParallelFlood;
+
+    /**
+     * @brief Headless minesweeper rules (no window, no SFML)
+     * Every action records the indices of the tiles whose state changed,
+     * so a front-end only has to redraw those (see changes()).
+     * Tiles are stored with a one-tile border of sentinels, so neighbour
+     * walks have no edge checks; where each tile is stored is up to the
+     * TileLayout (row by row, or in 8x8 blocks, see setLayout).
+     */
+    class Board
+    {
+    public:
+        // Default Constructor (You have to call reset to set board size)
+        Board();
+
+        Board(uint32_t width, uint32_t height, uint32_t mines);
+
+        /**
+         * @brief hides every tile, removes all mines/flags and resizes the board
+         *
+         * @param width board width in tiles
+         * @param height board height in tiles
+         * @param mines number of mines to put on generate()
+         * @return false if the size doesn't fit (see fits), the board is left as it was
+         */
+        bool reset(uint32_t width, uint32_t height, uint32_t mines);
+
+        /**
+         * @brief whether a board of that size can be made: at least one tile, and every
+         * tile index (border of sentinels included, in any layout) fits in 32 bits
+         *
+         * @param width board width in tiles
+         * @param height board height in tiles
+         */
+        static bool fits(uint64_t width, uint64_t height)
+        {
+            return width > 0 && height > 0 && width <= UINT32_MAX && height <= UINT32_MAX &&
+                   TileLayout::maxSize(width, height) <= UINT32_MAX;
+        }
+
+        /**
+         * @brief rebuilds a board from packed tiles (see Tile::pack), e.g. from a save file
+         * flag/opened counters are recomputed
+         *
+         * @param width board width in tiles
+         * @param height board height in tiles
+         * @param mines number of mines
+         * @param status status of the saved game
+         * @param packedTiles width * height packed tiles
+         * @return false if the tiles aren't a board of that size and mines (a state out of range,
+         * a counter that doesn't match the mines around it...), the board is then a new empty one
+         */
+        bool restore(uint32_t width, uint32_t height, uint32_t mines, GameStatus status, const uint8_t* packedTiles);
+
+        /**
+         * @brief puts mines in random tiles and updating their neighbours counter
+         * O(mines) at any density; same seed, first click and radius -> same board on every platform
+         *
+         * @param firstClickTileIndex tile that is guaranteed to have no mine
+         * @param seed random seed
+         * @param safeRadius tiles within this distance of the first click get no mine
+         * (1 -> first click always opens an empty tile; shrinks if there are too many mines)
+         */
+        void generate(uint32_t firstClickTileIndex, uint64_t seed, uint32_t safeRadius = 1);
+
+        /**
+         * @brief opens a tile, opening its empty neighbours too (player loses on a mine)
+         * player wins when every safe tile is open
+         *
+         * @param tileIndex1D index in 1Dim tiles array
+         * @return true if any tile changed
+         */
+        bool reveal(uint32_t tileIndex1D);
+
+        /**
+         * @brief sets/unsets a flag on a hidden tile
+         * when all flags are used the game ends (win only if all flags are on mines)
+         *
+         * @param tileIndex1D index in 1Dim tiles array
+         * @return true if the flag was set/unset
+         */
+        bool toggleFlag(uint32_t tileIndex1D);
+
+        /**
+         * @brief opens all non-flagged neighbours if number of flagged neighbours >= number of tile
+         * player loses if one of these flags is not on a mine
+         *
+         * @param tileIndex1D an opened tile
+         * @return true if neighbours were opened (or player lost)
+         * @return false if there are not enough flags around the tile
+         */
+        bool chord(uint32_t tileIndex1D);
+
+        /**
+         * @brief marks hidden neighbours of a tile as peeked (drawn as pressed) or back to hidden
+         *
+         * @param tileIndex1D the tile user peeked at
+         * @param peeking true to peek, false to stop peeking
+         */
+        void peek(uint32_t tileIndex1D, bool peeking);
+
+        /**
+         * @brief sets a tile's state decided somewhere else (co-op server), counters follow
+         * never ends the game (see finish)
+         *
+         * @param tileIndex1D index in 1Dim tiles array
+         * @param state tile's new state
+         */
+        void setTileState(uint32_t tileIndex1D, TileState state);
+
+        /**
+         * @brief ends a game decided somewhere else (co-op server), opens all mines
+         *
+         * @param userWon whether players won or not
+         */
+        void finish(bool userWon);
+
+        /**
+         * @brief check if player win (O(1), from counters kept on every state change)
+         *
+         * @return true when every safe tile is open, or all mined tiles are flagged and vice versa
+         * @return false otherwise
+         */
+        bool checkWin() const;
+
+        /**
+         * @brief calls visit(neighbourIndex1D, neighbourTile) for every neighbour of a tile
+         * storage neighbours from the layout, only sentinels are skipped (no edge checks)
+         *
+         * @param tileIndex1D index in 1Dim tiles array
+         * @param visit callable taking (uint32_t, const Tile&)
+         */
+        template <typename Visitor>
+        void forEachNeighbour(uint32_t tileIndex1D, Visitor&& visit) const
+        {
+            uint32_t around[8];
+            m_layout.neighbours(paddedIndex(tileIndex1D), around);
+            for (uint32_t k = 0; k < 8; ++k)
+            {
+                const Tile& neighbour = m_tiles[around[k]];
+                if (neighbour.m_state != TileState::sentinel)
+                    visit(tileIndex1D + m_offsets[k], neighbour);
+            }
+        }
+
+        /**
+         * @brief calls visit(col, tile) for every tile of a row, left to right
+         * (contiguous in the row-major layout)
+         *
+         * @param row board row
+         * @param visit callable taking (uint32_t, const Tile&)
+         */
+        template <typename Visitor>
+        void forEachInRow(uint32_t row, Visitor&& visit) const
+        {
+            if (m_layout.kind() == TileLayoutKind::rowMajor)
+            {
+                const Tile* tiles = &m_tiles[paddedIndex(row * m_width)];
+                for (uint32_t col = 0; col < m_width; ++col)
+                    visit(col, tiles[col]);
+                return;
+            }
+            for (uint32_t col = 0; col < m_width; ++col)
+                visit(col, m_tiles[m_layout.index(col + 1, row + 1)]);
+        }
+
+        // tiles opened by the last reveal() or chord(), in opening order
+        const std::vector<uint32_t>& revealed() const { return m_revealed; }
+
+        // tiles changed since last clearChanges()
+        const std::vector<uint32_t>& changes() const { return m_changes; }
+        void clearChanges() { m_changes.clear(); }
+        // headless boards (batch simulations) don't record changes nor open mines at game end
+        void setHeadless(bool headless) { m_headless = headless; }
+        // huge openings run on all cores with flood (nullptr -> always the single-threaded flood fill)
+        // revealed() is then row by row instead of in opening order
+        void setParallelFlood(ParallelFlood* flood) { m_flood = flood; }
+        // how tiles are stored from the next reset on (blocked: no parallel flood nor bulk counting, both walk rows)
+        void setLayout(TileLayoutKind layout) { m_layoutKind = layout; }
+        TileLayoutKind layout() const { return m_layout.kind(); }
+
+        const Tile& tile(uint32_t tileIndex1D) const { return m_tiles[paddedIndex(tileIndex1D)]; }
+        uint32_t width() const { return m_width; }
+        uint32_t height() const { return m_height; }
+        uint32_t size() const { return m_width * m_height; }
+        uint32_t mines() const { return m_mines; }
+        uint32_t flags() const { return m_flags; }
+        uint32_t correctFlags() const { return m_correctFlags; }
+        uint32_t wrongFlags() const { return m_wrongFlags; }
+        uint32_t revealedSafe() const { return m_revealedSafe; }
+        GameStatus status() const { return m_status; }
+        bool isFinished() const { return m_status == GameStatus::won || m_status == GameStatus::lost; }
+
+    private:
+        // index of a tile in the padded storage
+        uint32_t paddedIndex(uint32_t tileIndex1D) const { return m_layout.padded(tileIndex1D); }
+
+        /**
+         * @brief update one tile's state
+         *
+         * @param tileIndex1D index in 1Dim tiles array
+         * @param padded index in the padded storage (paddedIndex(tileIndex1D))
+         * @param state tile's new state
+         */
+        void setState(uint32_t tileIndex1D, uint32_t padded, TileState state);
+
+        /**
+         * @brief fills m_safeZone with the tiles within safeRadius of a tile (sorted)
+         *
+         * @param tileIndex1D center of the zone (first clicked tile)
+         * @param safeRadius distance from the center (0 -> only the center)
+         */
+        void setSafeZone(uint32_t tileIndex1D, uint32_t safeRadius);
+
+        /**
+         * @brief maps an index among the tiles outside the safe zone to a tile index
+         *
+         * @param candidate index in [0, size - safe zone size)
+         * @return uint32_t index in 1Dim tiles array
+         */
+        uint32_t skipSafeZone(uint32_t candidate) const;
+
+        /**
+         * @brief opens one hidden non-mined tile and queues it for unhideEmptyNeighbours
+         *
+         * @param tileIndex1D index in 1Dim tiles array
+         * @param padded index in the padded storage
+         */
+        void openTile(uint32_t tileIndex1D, uint32_t padded);
+
+        /**
+         * @brief opens/unhides non-mined neighbours of every empty tile queued in m_revealed
+         * iterative (no recursion), uses m_revealed/m_queue as the queue so it never allocates
+         *
+         * @param queueHead first tile of m_revealed that was not visited yet
+         * @param limit stops (without finishOpening) once more tiles than this are opened
+         * @return false if the limit was reached
+         */
+        bool unhideEmptyNeighbours(size_t queueHead, size_t limit = SIZE_MAX);
+
+        /**
+         * @brief records the opened tiles (m_revealed) as changes, player wins if every safe tile is open
+         *
+         */
+        void finishOpening();
+
+        /**
+         * @brief Ends the game and opens all hidden-mines
+         *
+         * @param userWon whether user won or not
+         */
+        void endGame(bool userWon);
+
+    private:
+        std::vector<Tile> m_tiles; // tile states with a border of sentinels, placed by m_layout
+        std::vector<uint32_t> m_changes; // indices of tiles changed since last clearChanges()
+        std::vector<uint32_t> m_revealed; // reveal queue/result, preallocated to size() on reset
+        std::vector<uint32_t> m_queue; // padded indices of m_revealed (the flood walks those)
+        TileLayout m_layout; // where each tile of m_tiles is
+        TileLayoutKind m_layoutKind = TileLayoutKind::rowMajor; // layout of the next reset
+        int32_t m_offsets[8] = {}; // neighbourSteps in tile indices (valid for tiles that aren't sentinels)
+        std::vector<uint32_t> m_safeZone; // tiles kept free of mines by generate()
+        uint32_t m_width = 0;
+        uint32_t m_height = 0;
+        uint32_t m_mines = 0; // Number of Mines in the map
+        uint32_t m_flags = 0; // Number of flags put by player
+        uint32_t m_correctFlags = 0; // flags on mines
+        uint32_t m_wrongFlags = 0; // flags on safe tiles (all flags before generate())
+        uint32_t m_revealedSafe = 0; // opened safe tiles
+        GameStatus m_status = GameStatus::notStarted;
+        bool m_headless = false; // nobody draws the board
+        ParallelFlood* m_flood = nullptr; // opens huge regions on all cores (not owned)
+    };
+};
@@ -0,0 +1,65 @@
+// BoardMetrics.h
+///////////////////////////////////////////
+#pragma once
+
+#include <Board.h>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace game
+{
+    // Difficulty of a generated board (computed in O(size), see computeMetrics)
+    struct BoardMetrics
+    {
+        uint32_t bbbv = 0; // 3BV: fewest clicks that clear the board without flags (openings + isolated numbers)
+        uint32_t openings = 0; // 8-connected areas of empty tiles (one click opens each with its border)
+        uint32_t isolatedNumbers = 0; // numbers that no opening opens (one click each)
+    };
+
+    // buffers reused by computeMetrics (nothing is allocated once they have grown to the board size)
+    struct MetricsScratch
+    {
+        std::vector<uint8_t> numbers; // mine counters with a border, mines and border are 9
+        std::vector<uint32_t> labels; // opening label of each empty tile (0 -> not empty)
+        std::vector<uint32_t> parents; // union-find forest of the labels
+        std::vector<uint8_t> nearEmpty; // 1 next to an empty tile (row pass, then 3x3)
+    };
+
+    /**
+     * @brief 3BV, openings and isolated numbers of a generated board
+     * openings are labelled with a two-pass connected-component scan: the first pass
+     * gives every empty tile the label of an empty tile above or left of it (and
+     * merges the labels that meet in a union-find), the openings are the roots left.
+     * isolated numbers are found with a branchless 3x3 "next to an empty tile" pass
+     *
+     * @param board generated board (tile states are ignored)
+     * @param scratch buffers reused between calls
+     */
+    BoardMetrics computeMetrics(const Board& board, MetricsScratch& scratch);
+
+    // Boards seed..seed + boards - 1 of one size, generated and measured on all cores
+    struct MetricsBatchConfig
+    {
+        uint32_t width = 30;
+        uint32_t height = 16;
+        uint32_t mines = 99;
+        uint64_t boards = 1;
+        uint64_t seed = 0; // board i is generated with seed + i
+        uint32_t firstClick = 0; // tile opened first (generate keeps it safe)
+        uint32_t safeRadius = 1; // see Board::generate
+        uint32_t threads = 0; // 0 -> one per core
+        uint32_t batchSize = 4096; // boards per task
+    };
+
+    /**
+     * @brief generates the boards of a batch on all cores and measures them
+     * batches are handed to consume in seed order on the calling thread, while the
+     * next batches are generated (a slow consumer holds a few batches in memory at most)
+     *
+     * @param config board size, seeds and threads
+     * @param consume called with the first board index of a batch and the metrics of its boards
+     */
+    void generateMetrics(const MetricsBatchConfig& config,
+                         const std::function<void(uint64_t, const std::vector<BoardMetrics>&)>& consume);
+};
@@ -0,0 +1,103 @@
+// ChunkStore.h
+///////////////////////////////////////////
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+
+namespace game
+{
+    // Fixed header at the start of a region file, written field by field (u32 little-endian after the magic)
+    struct RegionHeader
+    {
+        char magic[4] = {'M', 'S', 'R', 'G'};
+        uint32_t version = 1;
+        uint32_t chunkBytes = 0; // bytes of one chunk (slots are 1 + chunkBytes)
+        uint32_t reserved = 0;
+    };
+    static const uint32_t regionHeaderBytes = 16; // RegionHeader on disk
+
+    /**
+     * @brief On-disk store of evicted chunks (see EndlessBoard)
+     * Chunks are grouped in region files of regionSize x regionSize chunks. Every
+     * chunk has a fixed slot in its region (1 byte "written" + chunkBytes), so a
+     * chunk is rewritten in place and nothing is kept in memory to find it: memory
+     * stays the same however many chunks are stored. Slots never written are holes
+     * in the file. The files are scratch space of one game, removed by open and close.
+     */
+    class ChunkStore
+    {
+    public:
+        static const int64_t regionSize = 16; // chunks per region side
+
+        // Default Constructor (You have to call open)
+        ChunkStore();
+        ~ChunkStore();
+
+        ChunkStore(const ChunkStore&) = delete;
+        ChunkStore& operator=(const ChunkStore&) = delete;
+
+        /**
+         * @brief creates the directory, removing region files left by an earlier game
+         *
+         * @param directory where region files are written
+         * @param chunkBytes bytes of every chunk
+         * @return false if the directory couldn't be created
+         */
+        bool open(const std::filesystem::path& directory, uint32_t chunkBytes);
+
+        // removes the region files (and the directory if nothing else is in it)
+        void close();
+
+        /**
+         * @brief writes a chunk (over its earlier version)
+         *
+         * @param cx chunk column
+         * @param cy chunk row
+         * @param bytes chunkBytes bytes
+         * @return false if the region file couldn't be written
+         */
+        bool write(int64_t cx, int64_t cy, const uint8_t* bytes);
+
+        /**
+         * @brief reads a chunk written earlier
+         *
+         * @param cx chunk column
+         * @param cy chunk row
+         * @param bytes receives chunkBytes bytes
+         * @return false if the chunk was never written
+         */
+        bool read(int64_t cx, int64_t cy, uint8_t* bytes);
+
+        bool isOpen() const { return !m_directory.empty(); }
+        uint64_t chunksWritten() const { return m_written; }
+        uint64_t chunksRead() const { return m_read; }
+
+    private:
+        /**
+         * @brief makes m_file the region file of a chunk
+         *
+         * @param create create the file if it doesn't exist
+         * @return false if it doesn't exist (and create is false) or couldn't be opened
+         */
+        bool openRegion(int64_t cx, int64_t cy, bool create);
+
+        // position of a chunk's slot in its region file
+        std::streamoff slotOffset(int64_t cx, int64_t cy) const;
+
+        // removes the region files in m_directory (the directory may hold anything else too)
+        void removeRegionFiles();
+
+    private:
+        std::filesystem::path m_directory;
+        uint32_t m_chunkBytes = 0;
+        std::fstream m_file; // last region file used (consecutive chunks are mostly in the same region)
+        bool m_fileOpen = false;
+        int64_t m_fileRx = 0;
+        int64_t m_fileRy = 0;
+        uint64_t m_written = 0;
+        uint64_t m_read = 0;
+    };
+};
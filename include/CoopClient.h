@@ -0,0 +1,79 @@
+// CoopClient.h
+///////////////////////////////////////////
+#pragma once
+
+#include <SFML/Network.hpp>
+#include <Board.h>
+#include <CoopProtocol.h>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace game
+{
+    /**
+     * @brief Player of a co-op server (Game with main --join, load test bots)
+     * Actions are sent to the server, the board only changes from the server's
+     * updates: a local Board follows the shared one (same seed and first click ->
+     * same level, then the tile states of every update).
+     * The socket is non-blocking after connect, poll never waits.
+     */
+    class CoopClient
+    {
+    public:
+        /**
+         * @brief connects and makes board a copy of the shared board (waits for the server's welcome)
+         *
+         * @param host server address (name or IP)
+         * @param port server port
+         * @param board reset to the server's size, mines and tiles
+         * @param timeout connection timeout
+         * @return false if the server couldn't be reached
+         */
+        bool connect(const std::string& host, unsigned short port, Board& board, sf::Time timeout = sf::seconds(3.f));
+
+        void disconnect();
+
+        /**
+         * @brief queues an action for the server (sent by this call or the next polls)
+         *
+         * @param type reveal, flag or chord
+         * @param tileIndex1D index in 1Dim tiles array
+         */
+        void send(ActionType type, uint32_t tileIndex1D);
+
+        /**
+         * @brief sends queued actions and applies the updates received so far to board
+         * changed tiles are in board.changes() (unless board is headless)
+         *
+         * @param board board given to connect
+         * @return false once the server is gone
+         */
+        bool poll(Board& board);
+
+        bool isConnected() const { return m_connected; }
+        uint64_t seed() const { return m_seed; }
+        // tile changes received since connect
+        uint64_t changesReceived() const { return m_changesReceived; }
+
+    private:
+        /**
+         * @brief applies a welcome or update to board
+         *
+         * @return false if the packet is malformed
+         */
+        bool apply(sf::Packet& packet, Board& board);
+
+    private:
+        sf::TcpSocket m_socket;
+        bool m_connected = false;
+        std::deque<sf::Packet> m_outgoing; // actions not fully sent yet (front may be partly sent)
+        std::vector<uint32_t> m_versions; // latest version applied to every tile
+        std::vector<TileChange> m_changes; // changes of the packet being applied
+        uint64_t m_seed = 0;
+        uint32_t m_safeRadius = 1;
+        bool m_generated = false; // level generated around the server's first click
+        uint64_t m_changesReceived = 0;
+    };
+};
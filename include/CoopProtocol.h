@@ -0,0 +1,55 @@
+// CoopProtocol.h
+///////////////////////////////////////////
+#pragma once
+
+#include <SFML/Network.hpp>
+#include <SharedBoard.h>
+#include <Simulation.h>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace game
+{
+    // co-op server port (minesweeper_server --port, main --join host:port)
+    static const unsigned short coopDefaultPort = 47474u;
+
+    /**
+     * @brief First byte of every co-op packet (all numbers in sf::Packet's network byte order)
+     * action  (client -> server): type (ActionType), tile
+     * welcome (server -> client, once): width, height, mines, seed, safe radius, status, first click, changes
+     * update  (server -> clients): status, first click, changes (of every action since the last update)
+     * changes are a count then (tile, version << 8 | state) pairs
+     */
+    enum class CoopMessage : uint8_t
+    {
+        action, welcome, update
+    };
+
+    inline void writeChanges(sf::Packet& packet, const std::vector<TileChange>& changes)
+    {
+        packet << uint32_t(changes.size());
+        for (const TileChange& change : changes)
+            packet << change.tileIndex1D << (change.version << 8 | uint32_t(uint8_t(change.state)));
+    }
+
+    // false if the packet is too short
+    inline bool readChanges(sf::Packet& packet, std::vector<TileChange>& changes)
+    {
+        uint32_t count = 0;
+        if (!(packet >> count))
+            return false;
+        changes.clear();
+        // the count comes from the network: it can't be bigger than the packet
+        changes.reserve(std::min<size_t>(count, packet.getDataSize() / 8));
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            uint32_t tileIndex1D = 0;
+            uint32_t word = 0;
+            if (!(packet >> tileIndex1D >> word))
+                return false;
+            changes.push_back({tileIndex1D, word >> 8, TileState(uint8_t(word & 0xff))});
+        }
+        return true;
+    }
+};
@@ -0,0 +1,151 @@
+// CoopServer.h
+///////////////////////////////////////////
+#pragma once
+
+#include <SFML/Network.hpp>
+#include <CoopProtocol.h>
+#include <SharedBoard.h>
+#include <ThreadPool.h>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace game
+{
+    /**
+     * @brief Co-op server: clients on the network play one SharedBoard
+     * A network thread accepts clients and reads their actions, the actions run
+     * on a thread pool at the same time (the board needs no lock). Actions of one
+     * client run one at a time, in the order they were sent. Each action
+     * is resolved once (a flood fill runs on one worker); the changes of all
+     * actions since the last update are sent to every client as one update.
+     */
+    class CoopServer
+    {
+    public:
+        /**
+         * @brief
+         *
+         * @param board shared board (must outlive the server)
+         * @param threads threads running actions (0 -> one per core, minus the calling thread)
+         */
+        explicit CoopServer(SharedBoard& board, uint32_t threads = 0);
+
+        // disconnects every client
+        ~CoopServer();
+
+        CoopServer(const CoopServer&) = delete;
+        CoopServer& operator=(const CoopServer&) = delete;
+
+        /**
+         * @brief listens on a port and starts the network thread
+         *
+         * @param port TCP port (0 -> any free port, see port())
+         * @return false if the port couldn't be opened
+         */
+        bool start(unsigned short port);
+
+        // stops the network thread and disconnects every client
+        void stop();
+
+        unsigned short port() const { return m_listener.getLocalPort(); }
+        uint32_t clients() const { return m_clientCount.load(std::memory_order_relaxed); }
+        // actions run so far
+        uint64_t actions() const { return m_actions.load(std::memory_order_relaxed); }
+        // updates sent to clients (one per client per update)
+        uint64_t updatesSent() const { return m_updatesSent.load(std::memory_order_relaxed); }
+        // tile changes sent to clients (a flood counts once per client)
+        uint64_t changesSent() const { return m_changesSent.load(std::memory_order_relaxed); }
+
+        // the network thread sleeps at most this long (also the longest delay of an update)
+        static const int32_t pollIntervalMs = 2;
+        // a client with more actions waiting to run, or more updates waiting to be sent, is
+        // disconnected (it sends faster than the board plays, or doesn't read its socket)
+        static const size_t maxQueuedActions = 4096;
+        static const size_t maxQueuedUpdates = 1024;
+
+    private:
+        struct QueuedAction
+        {
+            ActionType type;
+            uint32_t tileIndex1D;
+        };
+
+        // actions of one client not run yet (shared with the pool task running them)
+        struct ActionQueue
+        {
+            std::mutex mutex;
+            std::deque<QueuedAction> actions;
+            bool running = false; // a pool task is running the queue
+        };
+
+        struct Client
+        {
+            sf::TcpSocket socket;
+            std::deque<sf::Packet> outgoing; // front may be partly sent
+            std::shared_ptr<ActionQueue> actions = std::make_shared<ActionQueue>();
+        };
+
+        // network thread loop
+        void run();
+
+        // sends the welcome to a new client (before any update it gets)
+        void accept();
+
+        /**
+         * @brief reads the actions a client sent and queues them to run on the pool
+         *
+         * @return false if the client left (or has too many actions queued)
+         */
+        bool receive(Client& client);
+
+        /**
+         * @brief runs the oldest action of a client on a pool worker, then defers itself
+         * while actions are queued (the tasks already queued on the worker run first)
+         *
+         * @param queue the client's actions
+         */
+        void runQueued(const std::shared_ptr<ActionQueue>& queue);
+
+        // runs an action on a pool worker, its changes go to the next update
+        void apply(ActionType type, uint32_t tileIndex1D);
+
+        // removes the clients that left (reset by receive/flush)
+        void dropClosedClients();
+
+        // one update of the changes since the last one, queued for every client (too far behind -> dropped)
+        void broadcast();
+
+        /**
+         * @brief sends what the socket takes from a client's queue
+         *
+         * @return false if the client left
+         */
+        bool flush(Client& client);
+
+    private:
+        SharedBoard& m_board;
+        sf::TcpListener m_listener;
+        sf::SocketSelector m_selector;
+        std::vector<std::unique_ptr<Client>> m_clients; // network thread only
+        std::atomic<uint32_t> m_clientCount {0};
+
+        std::mutex m_outboxMutex;
+        std::vector<TileChange> m_outbox; // changes of the actions run since the last update
+        std::vector<TileChange> m_sending; // swapped with m_outbox by broadcast
+        std::vector<std::vector<TileChange>> m_workerChanges; // changes of the running action, per worker
+        GameStatus m_sentStatus = GameStatus::notStarted; // status in the last update
+
+        std::atomic<uint64_t> m_actions {0};
+        std::atomic<uint64_t> m_updatesSent {0};
+        std::atomic<uint64_t> m_changesSent {0};
+        std::atomic<bool> m_stop {false};
+        std::thread m_thread;
+        // declared last: destroyed first, so no action runs once the rest goes away
+        ThreadPool m_pool;
+    };
+};
@@ -0,0 +1,219 @@
+// EndlessBoard.h
+///////////////////////////////////////////
+#pragma once
+
+#include <Board.h>
+#include <ChunkStore.h>
+#include <Tile.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+namespace game
+{
+    // A tile of an endless board, in tiles from the start tile (x right, y down)
+    struct EndlessPos
+    {
+        int64_t x = 0;
+        int64_t y = 0;
+    };
+
+    /**
+     * @brief Minesweeper rules on a board with no size (endless mode)
+     * The board is split in chunks of chunkSize x chunkSize tiles, made the first time
+     * a tile in them is looked at: whether a tile is a mine is a hash of the seed, its
+     * chunk's coordinates and its place in the chunk, so the mines of any chunk (and of
+     * the tiles around it, for the counters on its border) are known without the chunks
+     * next to it. At most maxChunks chunks are kept in memory; the least recently used
+     * one is dropped when another is needed, its tile states saved in a ChunkStore if the
+     * player changed any. A chunk made again gets its mines back from the hash and its
+     * states from the store. The start tile and its neighbours are never mines.
+     * Like Board, every action records the tiles whose state changed (see changes()).
+     */
+    class EndlessBoard
+    {
+    public:
+        static const int64_t chunkSize = 64; // tiles per chunk side
+        static const uint32_t chunkTiles = uint32_t(chunkSize * chunkSize);
+        static const uint32_t chunkStateBytes = chunkTiles / 4; // 2 bits per tile on disk
+        static const size_t defaultMaxChunks = 256; // 1 MB of tiles
+        static constexpr float minMineDensity = 0.15f; // fewer mines -> empty areas could be endless too
+        static constexpr float maxMineDensity = 0.9f;
+
+        // Default Constructor (You have to call reset)
+        EndlessBoard();
+
+        /**
+         * @brief starts a new endless board (nothing is generated yet)
+         *
+         * @param seed level seed (same seed -> same mines everywhere)
+         * @param mineDensity chance of a tile to be a mine (clamped to [minMineDensity, maxMineDensity])
+         * @param storeDirectory where evicted chunks are written (scratch files, removed with the board)
+         * @param maxChunks chunks kept in memory (at least 16)
+         * @return false if the store couldn't be opened
+         */
+        bool reset(uint64_t seed, float mineDensity, const std::filesystem::path& storeDirectory,
+                   size_t maxChunks = defaultMaxChunks);
+
+        /**
+         * @brief opens a tile, opening its empty neighbours too (player loses on a mine)
+         *
+         * @param pos tile to open
+         * @return true if any tile changed
+         */
+        bool reveal(const EndlessPos& pos);
+
+        /**
+         * @brief sets/unsets a flag on a hidden tile
+         *
+         * @param pos tile to flag
+         * @return true if the flag was set/unset
+         */
+        bool toggleFlag(const EndlessPos& pos);
+
+        /**
+         * @brief opens all non-flagged neighbours if number of flagged neighbours >= number of tile
+         * player loses if one of these flags is not on a mine
+         *
+         * @param pos an opened tile
+         * @return true if neighbours were opened (or player lost)
+         */
+        bool chord(const EndlessPos& pos);
+
+        /**
+         * @brief marks hidden neighbours of a tile as peeked (drawn as pressed) or back to hidden
+         *
+         * @param pos the tile user peeked at
+         * @param peeking true to peek, false to stop peeking
+         */
+        void peek(const EndlessPos& pos, bool peeking);
+
+        /**
+         * @brief a tile (its chunk is made or loaded if it isn't in memory)
+         * the reference is valid until the next call that looks at another chunk
+         *
+         * @param pos any tile
+         */
+        const Tile& tile(const EndlessPos& pos);
+
+        // tiles changed since last clearChanges()
+        const std::vector<EndlessPos>& changes() const { return m_changes; }
+        void clearChanges() { m_changes.clear(); }
+
+        GameStatus status() const { return m_status; }
+        bool isFinished() const { return m_status == GameStatus::lost; }
+        // safe tiles opened (the score)
+        uint64_t revealedSafe() const { return m_revealedSafe; }
+        uint64_t flags() const { return m_flags; }
+        uint64_t seed() const { return m_seed; }
+        size_t chunksInMemory() const { return m_chunks.size(); }
+        uint64_t chunksMade() const { return m_chunksMade; }
+        uint64_t chunksEvicted() const { return m_chunksEvicted; }
+        const ChunkStore& store() const { return m_store; }
+
+    private:
+        struct Chunk
+        {
+            int64_t cx = 0;
+            int64_t cy = 0;
+            bool dirty = false; // states changed since the chunk was made/loaded
+            std::array<Tile, chunkTiles> tiles;
+        };
+
+        struct ChunkKey
+        {
+            int64_t cx;
+            int64_t cy;
+            bool operator==(const ChunkKey& other) const { return cx == other.cx && cy == other.cy; }
+        };
+
+        struct ChunkKeyHash
+        {
+            size_t operator()(const ChunkKey& key) const;
+        };
+
+        /**
+         * @brief the chunk of a tile, made or loaded (and something else evicted) if needed
+         *
+         * @param pos any tile
+         * @return Chunk& valid until the next call that looks at another chunk
+         */
+        Chunk& chunkOf(const EndlessPos& pos);
+
+        /**
+         * @brief sets the mines and counters of a new chunk, then the states saved in the store
+         *
+         * @param chunk chunk with cx/cy set
+         */
+        void makeChunk(Chunk& chunk);
+
+        /**
+         * @brief saves the least recently used chunk's states if it is dirty and drops it
+         *
+         * @return false if its states couldn't be saved (it is kept, as the most recently used)
+         */
+        bool evictChunk();
+
+        /**
+         * @brief whether a tile is a mine (same answer for a tile wherever it is asked from)
+         *
+         * @param x tile column
+         * @param y tile row
+         */
+        bool isMine(int64_t x, int64_t y) const;
+
+        /**
+         * @brief update one tile's state
+         *
+         * @param chunk chunk of the tile
+         * @param pos the tile
+         * @param state tile's new state
+         */
+        void setState(Chunk& chunk, const EndlessPos& pos, TileState state);
+
+        /**
+         * @brief opens one hidden non-mined tile and queues it for unhideEmptyNeighbours
+         *
+         * @param pos the tile
+         */
+        void openTile(const EndlessPos& pos);
+
+        /**
+         * @brief opens/unhides non-mined neighbours of every empty tile queued in m_queue
+         * iterative (no recursion), chunks are made as the opening reaches them
+         *
+         */
+        void unhideEmptyNeighbours();
+
+        /**
+         * @brief Ends the game and opens the mines of the chunks in memory
+         *
+         */
+        void endGame();
+
+        // place of a tile in its chunk
+        static uint32_t localIndex(const EndlessPos& pos);
+
+    private:
+        std::list<Chunk> m_chunks; // chunks in memory, most recently used first
+        std::unordered_map<ChunkKey, std::list<Chunk>::iterator, ChunkKeyHash> m_chunkIndex;
+        Chunk* m_lastChunk = nullptr; // chunk of the last tile looked at (tiles are mostly looked at near each other)
+        size_t m_maxChunks = defaultMaxChunks;
+        ChunkStore m_store; // states of evicted chunks
+        std::vector<uint8_t> m_packed; // one chunk's states, 2 bits per tile (store buffer)
+        std::vector<uint8_t> m_halo; // mines of a chunk being made and of the tiles around it
+        std::vector<EndlessPos> m_changes; // tiles changed since last clearChanges()
+        std::vector<EndlessPos> m_queue; // reveal queue
+        uint64_t m_seed = 0;
+        uint64_t m_mineThreshold = 0; // a tile is a mine if its hash is below this
+        GameStatus m_status = GameStatus::notStarted;
+        uint64_t m_revealedSafe = 0;
+        uint64_t m_flags = 0;
+        uint64_t m_chunksMade = 0;
+        uint64_t m_chunksEvicted = 0;
+    };
+};
@@ -0,0 +1,111 @@
+// EndlessGame.h
+///////////////////////////////////////////
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <AssetCache.h>
+#include <EndlessBoard.h>
+#include <GameConstants.h>
+#include <RenderScheduler.h>
+#include <Tilemap.h>
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace game
+{
+    /**
+     * @brief Endless mode window (main --endless): an EndlessBoard seen through the window
+     * The Tilemap only covers the window (plus one tile); panning moves it by less than
+     * a tile and, when the top-left tile changes, rewrites its tiles from the board, so
+     * chunks are made only when the view (or an opening) reaches them. No zoom: the
+     * map would have to grow with the view.
+     */
+    class EndlessGame
+    {
+    public:
+        // Default Constructor (You have to call init to initialize game)
+        EndlessGame();
+
+        /**
+         * @brief Init The Game (should be called before run), the start tile is opened
+         *
+         * @param _tilesetPath tileset texture
+         * @param tileSize tile size in the tileset (pixels)
+         * @param mineDensity chance of a tile to be a mine
+         * @param seed level seed (same seed -> same mines everywhere)
+         * @return false if assets or the chunk store couldn't be loaded
+         */
+        bool init(const std::filesystem::path& _tilesetPath, uint16_t tileSize, float mineDensity, uint64_t seed);
+
+        /**
+         * @brief Game/Main Loop
+         *
+         * @return true if game finishes (player opened a mine) before player closing window
+         * @return false if player closes window
+         */
+        bool run();
+
+    private:
+        void handleEvent(const std::optional<sf::Event>& event);
+
+        /**
+         * @brief moves the view
+         *
+         * @param offset offset in board pixels
+         */
+        void panView(sf::Vector2<int64_t> offset);
+
+        /**
+         * @brief sizes the tilemap to the window and rewrites all its tiles
+         *
+         */
+        void reloadTiles();
+
+        /**
+         * @brief redraws tiles changed by the last board action (those in the view) and ends the game if player lost
+         *
+         */
+        void syncBoard();
+
+        // rewrites the score and flags texts
+        void updateHud();
+
+        /**
+         * @brief returns the board tile at a position on screen
+         *
+         * @param screenPos screen position (according to sfml)
+         */
+        EndlessPos tileFromScreenPos(const sf::Vector2i& screenPos) const;
+
+        // prints the score and how many chunks were made/evicted/stored
+        void printStats() const;
+
+    private:
+        sf::RenderWindow window;
+        uint16_t tileSize = 32; // tile size in pixel (e.g. 64 x 64)
+        EndlessBoard board;
+        Tilemap tilemap; // the tiles in the window
+        const sf::Texture* tileset = nullptr;
+        uint32_t columns = 0; // tiles in the tilemap
+        uint32_t rows = 0;
+        sf::Vector2<int64_t> camera; // board pixel at the window's top-left corner (start tile is at 0, 0)
+        EndlessPos origin; // board tile at the tilemap's top-left
+        sf::View view; // window pixels
+        bool panning = false; // middle button is held
+        sf::Vector2i panLastPos; // last cursor position while panning
+        bool wasPeeking = false;
+        EndlessPos tilePeeked;
+
+        sf::Clock clock; // restarted when the game ends
+        sf::Font noFont; // texts are built with it, init points them at the cached font
+        sf::Text scoreText {noFont};
+        sf::Text flagsText {noFont};
+        RenderScheduler scheduler; // draws only when something visible changed
+        static constexpr int32_t endGameDelayMs = 3500; // window closes this long after game ends
+        bool gameFinished = false;
+    };
+};
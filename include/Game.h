@@ -3,30 +3,67 @@
 #pragma once
 
 #include <SFML/Graphics.hpp>
+#include <AssetCache.h>
+#include <Board.h>
+#include <CoopClient.h>
+#include <GameConstants.h>
+#include <Generator.h>
+#include <ParallelFlood.h>
+#include <ProbabilityEstimator.h>
+#include <Profiler.h>
+#include <Recording.h>
+#include <SaveFile.h>
+#include <RenderScheduler.h>
+#include <Solver.h>
+#include <SpscQueue.h>
+#include <ThreadPool.h>
 #include <Tilemap.h>
 #include <Tile.h>
+#include <TripleBuffer.h>
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <iomanip>
 #include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
 
 namespace game
 {
-    // Static Data
-    static const uint16_t width = 16u;
-    static const uint16_t height = 16u;
     ////////////////////////////////////////////////
     // Convert Dimensions (1D to 2D)
     // sf::Vector2u convertDim1To2(uint16_t oneDim, uint16_t width);
     // Convert Dimensions (2D to 1D)
     // uint16_t convertDim2To1(const sf::Vector2u& twoDim, uint16_t width);
 
+    /**
+     * @brief Window, input and drawing on the calling thread, board rules on a logic thread
+     * run() starts the logic thread: input goes to it as commands, changed tiles come back
+     * through a queue and everything else shown (flags, hint, heatmap, game status) as the
+     * latest LogicState. Neither thread waits for the other, so a big opening or solver
+     * step never delays a frame.
+     */
     class Game
     {
     public:
         // Default Constructor (You have to call init to initialize game)
         Game();
 
-        // Init The Game (should be called before run)
-        bool init(const std::filesystem::path& _tilesetPath, uint16_t tileSize);
+        /**
+         * @brief Init The Game (should be called before run)
+         * 
+         * @param _tilesetPath tileset texture
+         * @param tileSize tile size in the tileset (pixels)
+         * @param width board width in tiles
+         * @param height board height in tiles
+         * @param mines number of mines
+         * @param seed level seed (same seed and first click -> same level)
+         * @param noGuess generate a level that can be solved without guessing
+         * @return false if assets couldn't be loaded
+         */
+        bool init(const std::filesystem::path& _tilesetPath, uint16_t tileSize,
+                  uint32_t width, uint32_t height, uint32_t mines, uint64_t seed, bool noGuess = false);
         
         /**
          * @brief Game/Main Loop
@@ -35,110 +72,311 @@ namespace game
          * @return false if player closes window
          */
         bool run();
+
+        /**
+         * @brief records every action of the next games to a file (overwritten on each game)
+         * 
+         * @param path recording file (empty -> don't record)
+         */
+        void setRecordingPath(const std::filesystem::path& path) { recordingPath = path; }
+
+        /**
+         * @brief saves the next games to a file (autosaved while playing), resumed by init if unfinished
+         * 
+         * @param path save file (empty -> don't save)
+         */
+        void setSavePath(const std::filesystem::path& path) { savePath = path; }
+
+        /**
+         * @brief plays the next games on a co-op server's shared board (see minesweeper_server)
+         * the server's board size and seed win over the ones given to init
+         * 
+         * @param host server address (empty -> play alone)
+         * @param port server port
+         */
+        void setServer(const std::string& host, unsigned short port) { coopHost = host; coopPort = port; }
+
+#ifdef MINESWEEPER_PROFILER
+        /**
+         * @brief writes the frame profile (every timed zone of every frame) to a CSV file, flushed when run returns
+         * 
+         * @param path CSV file (empty -> don't export)
+         */
+        void setProfilePath(const std::filesystem::path& path);
+#endif
         
     private:
+        // player input handed to the logic thread
+        struct Command
+        {
+            enum class Type : uint8_t
+            {
+                reveal,
+                flag,
+                chord, // both buttons pressed (chord or peek)
+                release, // a button released (ends peeking)
+                hint, // hint shown/hidden
+                heatmap // heatmap shown/hidden
+            };
+            Type type = Type::reveal;
+            uint32_t tileIndex1D = 0; // reveal, flag, chord
+            int32_t timeMs = 0; // game clock when the input happened
+            bool on = false; // hint, heatmap
+        };
+
+        // tile the render thread redraws
+        struct TileUpdate
+        {
+            uint32_t tileIndex1D = 0;
+            uint16_t mapIndex = 0;
+        };
+
+        // everything the render thread shows besides the tiles
+        struct LogicState
+        {
+            uint32_t flags = 0;
+            GameStatus status = GameStatus::notStarted;
+            uint64_t commandsDone = 0; // commands handled so far
+            bool hintVisible = false;
+            Hint hint;
+            bool heatmapSampling = false; // the heatmap will get finer
+            uint64_t heatmapVersion = 0; // changes with every estimate read
+            std::vector<float> heatmap; // mine probability of every tile (-1 -> no color)
+        };
+
+        void handleEvent(const std::optional<sf::Event>& event);
+
         /**
-         * @brief puts mines in random tiles and updating their neighbours counter
+         * @brief hands a command to the logic thread (render thread)
          * 
+         * @param command input to apply to the board
          */
-        void generateLevel(uint16_t firstClickTileIndex);
-    
+        void sendCommand(const Command& command);
+
         /**
-         * @brief update one tile's state
+         * @brief redraws tiles changed by the logic thread and shows its latest state (render thread)
+         * at most maxTileUpdatesPerFrame tiles per call, a huge opening is drawn over a few frames
          * 
-         * @param tileIndex1D index in 1Dim tiles array
-         * @param state tile's new state
          */
-        void updateTile(uint16_t tileIndex1D, const TileState& state);
+        void applyLogicUpdates();
+
+        // starts/stops the logic thread (stop waits for it)
+        void startLogic();
+        void stopLogic();
+
+        // logic thread: applies commands and co-op updates to the board until stopLogic
+        void logicLoop();
 
         /**
-         * @brief update one tile's state
+         * @brief applies one command to the board (logic thread)
          * 
-         * @param tilePtr  tile pointer
-         * @param state tile's new state
+         * @param command input from the render thread
          */
-        void updateTile(Tile* tilePtr, const TileState& state);
+        void handleCommand(const Command& command);
+
+        // logic thread: hands the current state to the render thread
+        void publishState();
 
         /**
-         * @brief Get array of pointers to neighbours of one tile
+         * @brief time the main loop can sleep waiting for events
          * 
-         * @param tileIndex1D index in 1Dim tiles array
-         * @param neighbours array of pointers (PLEASE MAKE SURE THAT THIS IS ALLOCATED IN MEMORY)
-         * @return uint16_t number of neighbours found (max: 8)
-         * Neighbours can be [down left, left, up left, up, up right, right, down right, down]
+         * @return sf::Time time until the next timer second or end-game close (Zero -> wait for an event)
          */
-        uint16_t getNeighbours8(const uint16_t tileIndex1D, Tile** neighbours);
+        sf::Time timeUntilWakeUp() const;
 
+        // prints how many frames were drawn and skipped (vs. drawing every frame)
+        void printFrameStats() const;
+
+#ifdef MINESWEEPER_PROFILER
+        // rewrites the profiler overlay with the p50/p99 time of every zone
+        void updateProfileOverlay();
+#endif
 
         /**
-         * @brief Get array of pointers to hidden-close neighbours of one tile
-         * a hidden neighbour: is a tile whose state is TileState::hidden
-         * a close neighbour can be [down, left, up, right]
-         * @param tileIndex1D index in 1Dim tiles array
-         * @param neighbours array of pointers (PLEASE MAKE SURE THAT THIS IS ALLOCATED IN MEMORY)
-         * @return uint16_t number of hidden-close neighbours found (max: 4)
+         * @brief sends tiles changed by the last board action to the render thread and ends the game if board is finished
+         * (logic thread)
+         * 
          */
-        uint16_t getHiddenNeighbours8(const uint16_t tileIndex1D, Tile** neighbours);
-        
-        void handleEvent(const std::optional<sf::Event>& event);
+        void syncBoard();
+
+        /**
+         * @brief finds the solver's next deduction for the hint marker (none if hints are off or nothing is known)
+         * (logic thread)
+         * 
+         */
+        void updateHint();
 
         /**
-         * @brief opens/unhides non-mined neighbours of a given tile
+         * @brief (re)starts the mine probability estimate of the heatmap from the current board (logic thread)
          * 
-         * @param index1D index in 1Dim tiles array
          */
-        void unhideEmptyNeighbours(uint16_t index1D);
+        void restartHeatmap();
 
+        /**
+         * @brief reads the latest estimate for the heatmap (logic thread, never waits for the sampling threads)
+         * 
+         */
+        void updateHeatmap();
 
         /**
-         * @brief check if player win 
+         * @brief builds one transparent quad per tile for the heatmap (render thread)
          * 
-         * @return false if any tile with a flag is not mined or vice versa
-         * @return true when all mined tiles are flagged and vice versa
          */
-        bool checkWin();
+        void buildHeatmap();
 
         /**
-         * @brief Ends the game, opens all hidden-mines and resets clock/timer
+         * @brief recolors the heatmap (render thread)
+         * 
+         * @param values mine probability of every tile (-1 -> no color)
+         */
+        void recolorHeatmap(const std::vector<float>& values);
+
+        /**
+         * @brief Ends the game: prints the result and saves the recording (logic thread)
+         * the render thread closes the window once it sees the finished state
          * 
          * @param userWon whether user won or not
          */
         void endGame(bool userWon);
 
         /**
-         * @brief Peek tile's neighbours and open them if number of flagged neighbours >= number of tile
+         * @brief records an action with the game clock time (before it is applied)
+         * 
+         * @param type action type
+         * @param tileIndex1D tile the action is on
+         * @param timeMs game clock when the action happened
+         */
+        void recordAction(ActionType type, uint32_t tileIndex1D, int32_t timeMs);
+
+        // finishes the recording with the board state and writes it (if a recording path is set)
+        void saveRecording();
+
+        // game clock in milliseconds (including the time played before a resume), render thread
+        int32_t gameTimeMs() const { return resumedMs + clock.getElapsedTime().asMilliseconds(); }
+
+        /**
+         * @brief Peek tile's neighbours and open them if number of flagged neighbours >= number of tile (logic thread)
          * 
          * @param tileIndex1D the tile user peeked at 
          * @return true user was peeking not openning tiles -- this sets the wasPeeking state to true
          * @return false user was openning tiles -- don't set wasPeeking state
          */
-        bool peekNeighbours(uint16_t tileIndex1D);
+        bool peekNeighbours(uint32_t tileIndex1D);
+
+        /**
+         * @brief shows the whole board
+         * 
+         */
+        void resetView();
+
+        /**
+         * @brief zooms the board view keeping the board point under the cursor in place
+         * 
+         * @param factor view size multiplier (< 1 zooms in)
+         * @param screenPos zoom center in window pixels
+         */
+        void zoomView(float factor, const sf::Vector2i& screenPos);
+
+        /**
+         * @brief moves the board view (center stays on the board)
+         * 
+         * @param offset offset in board pixels
+         */
+        void panView(const sf::Vector2f& offset);
 
         /**
          * @brief returns tileIndex in 1-D array of given position on screen
          * 
          * @param screenPos screen position (according to sfml)
-         * @return uint16_t index of tile in 1D array 
+         * @return uint32_t index of tile in 1D array (board size if position is outside the board)
          */
-        uint16_t tileIndexFromScreenPos(const sf::Vector2i& screenPos);
+        uint32_t tileIndexFromScreenPos(const sf::Vector2i& screenPos);
 
     private:
 
         // Member Fields
+        // between init and the end of run, the logic thread owns board, solver, recorder, saveFile,
+        // probabilities and coop; the render thread only reads the board size
         sf::RenderWindow window;
         uint16_t tileSize; // tile size in pixel (e.g. 64 x 64)
-        Tile tiles[width * height]; // array of structs representing tile states
-        Tilemap board; // the board that is drawn
+        Board board; // game rules and tile states
+        Tilemap tilemap; // the board that is drawn
+        Solver solver; // deductions from opened tiles, updated on every board change once hints were asked for
+        bool solverReady = false; // solver was reset on this game's board (on the first hint)
+        bool showHint = false; // H toggles the hint marker
+        bool hintVisible = false; // marker is on a tile
+        sf::RectangleShape hintMarker; // green: safe to open, red: mine
+        ThreadPool pool; // background work (must outlive probabilities)
+        ProbabilityEstimator probabilities {pool}; // Monte Carlo mine probabilities, refined in the background
+        ParallelFlood flood {pool}; // opens huge regions on all cores (see Board::setParallelFlood)
+        bool showHeatmap = false; // P toggles the mine probability heatmap
+        sf::VertexArray heatmap {sf::PrimitiveType::Triangles}; // one quad per tile, green (safe) to red (mine)
+        uint64_t heatmapVersion = 0; // estimate the heatmap shows
+        static constexpr int32_t heatmapRefreshMs = 100; // recolor at most this often while sampling
+        static constexpr uint32_t heatmapMaxTiles = 1u << 18; // bigger boards have no heatmap
+        sf::View boardView; // zoomed/panned view of the board
+        sf::View hudView; // timer and mines texts
+        bool panning = false; // middle button is held
+        sf::Vector2i panLastPos; // last cursor position while panning
+        static constexpr float zoomStep = 1.25f; // view size multiplier per wheel step
         std::filesystem::path tilesetPath;
+        uint64_t seed; // level seed, used on first click
+        bool noGuess = false; // first click generates a level solvable without guessing
+        Recorder recorder; // every action of the current game
+        std::filesystem::path recordingPath;
+        SaveFile saveFile; // memory-mapped save of the current game
+        std::filesystem::path savePath;
+        static constexpr int32_t autosaveIntervalMs = 2000; // dirty pages are flushed this often
+        bool resumed = false; // current game was loaded from savePath
+        int32_t resumedMs = 0; // game clock when the game was saved
+        CoopClient coop; // connected -> actions go to the server, the board follows its updates
+        std::string coopHost;
+        unsigned short coopPort = coopDefaultPort;
+        static constexpr int32_t coopPollMs = 15; // other players' actions show up this often
 
-        const uint16_t mines = (width * height) / 4; // Number of Mines in the map -- relative to board size
-        uint16_t flags = 0; // Number of flags put by player
-        uint16_t mapIndices[width * height];
+        // logic thread (runs while run() does)
+        std::thread logicThread;
+        std::atomic<bool> logicStopping {false};
+        std::mutex logicWakeMutex; // logic thread sleeps on logicWake until a command arrives
+        std::condition_variable logicWake;
+        SpscQueue<Command> commands {1024}; // render -> logic
+        SpscQueue<TileUpdate> tileUpdates {1u << 18}; // logic -> render, changed tiles in order
+        TripleBuffer<LogicState> logicState; // logic -> render, latest state only
+        uint64_t commandsSent = 0; // render thread: commands handed to the logic thread
+        static constexpr uint32_t maxTileUpdatesPerFrame = 1u << 16; // tiles redrawn per frame at most
+        static constexpr int32_t logicIdleMs = 250; // logic thread wakes up this often without commands
+        static constexpr int32_t pendingFrameMs = 16; // render thread wakes up this often while logic work is pending
+        // logic thread only
+        bool logicShowHint = false; // hints on (follows showHint)
+        bool logicShowHeatmap = false; // heatmap on (follows showHeatmap)
+        Hint hint; // solver's deduction shown by the marker
+        bool hintFound = false; // hint holds a deduction
+        std::vector<float> heatmapValues; // last estimate read
+        uint32_t heatmapSamples = 0; // samples of heatmapValues
+        uint64_t heatmapValuesVersion = 0; // counts the estimates read
+        sf::Clock heatmapClock; // time since the estimate was read
+        bool wasPeeking = false; // both buttons held on tilePeekedIndex1D
+        uint32_t tilePeekedIndex1D = 0;
+        int32_t logicTimeMs = 0; // game clock of the last command
+        uint64_t commandsDone = 0;
+        bool stateChanged = false; // something to publish
+        bool gameEnded = false; // endGame was called
 
         sf::Clock clock;
-        sf::Font font;
-        sf::Text timerText {font};
-        sf::Text minesText {font};
+        sf::Font noFont; // texts are built with it, init points them at the cached font
+        sf::Text timerText {noFont};
+        sf::Text minesText {noFont};
+        int32_t timerSeconds = 0; // seconds shown by timerText
+        RenderScheduler scheduler; // draws only when something visible changed
+#ifdef MINESWEEPER_PROFILER
+        bool showProfile = false; // F3 toggles the profiler overlay
+        sf::Text profileText {noFont}; // p50/p99 per zone
+        sf::Clock profileClock; // time since the overlay was rewritten
+        uint64_t frameStartNs = 0; // profiler clock when the current frame started
+        std::filesystem::path profilePath; // CSV export
+        static constexpr int32_t profileRefreshMs = 500; // rewrite the overlay this often while shown
+#endif
+        static constexpr int32_t endGameDelayMs = 3500; // window closes this long after game ends
 
         bool gameFinished;
         bool gameStarted;
@@ -3,10 +3,18 @@
 
 namespace game
 {
-    // Static Data
-    static const uint16_t width = 16u;
-    static const uint16_t height = 16u;
+    // Default board (board size and mines are chosen at runtime, see main)
+    static const uint32_t defaultWidth = 16u;
+    static const uint32_t defaultHeight = 16u;
+    static const float defaultMineDensity = 0.25f; // mines relative to board size
+    static const float defaultEndlessMineDensity = 0.16f; // chance of a tile to be a mine in endless mode
     static const uint16_t topMargin = 80u;
 
+    // assets (read once per process, see AssetCache)
+    static const char* const iconPath = "res/png/mine-icon-256.png";
+    static const char* const fontPath = "res/fonts/DS-DIGI.TTF";
+    static const char* const tileset32Path = "res/png/tilemap-new-32.png";
+    static const char* const tileset64Path = "res/png/tilemap-new-64.png";
+
 
 };
\ No newline at end of file
@@ -9,6 +9,6 @@ namespace game
     {
     public:
     private:
-        Tilemap board[width * height];
+        Tilemap board;
     };
 };
\ No newline at end of file
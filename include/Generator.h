@@ -0,0 +1,81 @@
+// Generator.h
+///////////////////////////////////////////
+#pragma once
+
+#include <Board.h>
+#include <Solver.h>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace game
+{
+    // Level that can be solved from the first click without guessing
+    struct NoGuessConfig
+    {
+        uint32_t width = 16;
+        uint32_t height = 16;
+        uint32_t mines = 40;
+        uint32_t firstClick = 0; // tile opened first (it generates the level)
+        uint64_t seed = 0; // same seed and first click -> same level (unless the budget runs out)
+        uint32_t safeRadius = 1; // see Board::generate
+        uint32_t threads = 0; // 0 -> one per core
+        double budgetMs = 16.0; // give up (and generate a normal level) after this long
+    };
+
+    // How a candidate board ended
+    enum class CandidateOutcome : char // 1-byte
+    {
+        solved, needsGuess, cancelled
+    };
+
+    struct CandidateResult
+    {
+        uint64_t index = 0; // candidate number (its seed is candidateSeed(seed, index))
+        double milliseconds = 0.0; // time spent generating and solving it
+        CandidateOutcome outcome = CandidateOutcome::cancelled;
+    };
+
+    struct NoGuessStats
+    {
+        bool found = false; // false -> budget ran out, board is a normal level of config.seed
+        uint64_t candidateIndex = 0; // winning candidate
+        uint64_t candidateSeed = 0; // seed the board was generated with
+        double elapsedMs = 0.0;
+        std::vector<CandidateResult> candidates; // every candidate tried, by index
+    };
+
+    /**
+     * @brief seed of one candidate board
+     *
+     * @param seed level seed
+     * @param index candidate number
+     */
+    uint64_t candidateSeed(uint64_t seed, uint64_t index);
+
+    /**
+     * @brief plays a board from the first click with only the solver's deductions
+     *
+     * @param board generated board (headless is recommended)
+     * @param solver solver to reuse (reset on the board)
+     * @param firstClick tile to open first
+     * @param cancelled polled between moves, stops the check when it returns true (may be empty)
+     * @return CandidateOutcome solved if every safe tile was opened without guessing
+     */
+    CandidateOutcome solveWithoutGuessing(Board& board, Solver& solver, uint32_t firstClick,
+                                          const std::function<bool()>& cancelled = {});
+
+    /**
+     * @brief generates a level that needs no guess, trying candidates on all cores
+     * the candidate with the lowest index that solves wins. That only makes the result
+     * independent of thread timing when generation finishes within the budget: at the
+     * deadline a lower candidate may still be running, and a higher one that solved
+     * first wins (stats.candidateSeed always replays the level)
+     *
+     * @param board board to generate (reset to config size unless it is a new board of that size, whose flags are kept)
+     * @param config size, first click, seed and time budget
+     * @param stats filled with the winning candidate and every candidate tried
+     * @return true if a no-guess level was found in budget
+     */
+    bool generateNoGuess(Board& board, const NoGuessConfig& config, NoGuessStats& stats);
+};
@@ -0,0 +1,71 @@
+// ParallelFlood.h
+///////////////////////////////////////////
+#pragma once
+
+#include <ThreadPool.h>
+#include <Tile.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace game
+{
+    /**
+     * @brief Opens a huge empty region on all cores (used by Board::reveal, see Board::setParallelFlood)
+     * The board is cut into strips of rows. Every strip labels its empty tiles on its
+     * own with a two-pass connected-component scan, then the labels that touch across
+     * strip borders are merged in a lock-free union-find (links only go from a bigger
+     * root to a smaller one, with a CAS). The tiles in the clicked region, and their
+     * neighbours, are then opened strip by strip. Work and memory are O(board size),
+     * so it only pays off when the region is big.
+     */
+    class ParallelFlood
+    {
+    public:
+        /**
+         * @brief
+         *
+         * @param pool pool running the strips (must outlive the flood)
+         */
+        explicit ParallelFlood(ThreadPool& pool);
+
+        ParallelFlood(const ParallelFlood&) = delete;
+        ParallelFlood& operator=(const ParallelFlood&) = delete;
+
+        /**
+         * @brief opens the empty region of a tile and the tiles around it (what Board's flood fill opens)
+         * only hidden or peeked tiles are opened, flags and opened tiles stop the region
+         *
+         * @param tiles board tiles with a one-tile border ((width + 2) * (height + 2))
+         * @param width board width in tiles
+         * @param height board height in tiles
+         * @param start padded index of a hidden empty tile
+         * @param opened filled with the indices (not padded) of the opened tiles, row by row
+         */
+        void reveal(Tile* tiles, uint32_t width, uint32_t height, uint32_t start, std::vector<uint32_t>& opened);
+
+        // strips are at least this many rows (fewer, bigger strips on small boards)
+        static const uint32_t minStripRows = 32;
+        // strips per worker (smaller strips balance uneven regions)
+        static const uint32_t stripsPerWorker = 4;
+
+    private:
+        // runs task(strip) for every strip on the pool and waits for all of them
+        template <typename Task>
+        void forEachStrip(uint32_t strips, const Task& task);
+
+        uint32_t findRoot(uint32_t label);
+        void unite(uint32_t a, uint32_t b);
+
+    private:
+        // label of a tile that is not in any empty region
+        static const uint32_t none = UINT32_MAX;
+
+        ThreadPool& m_pool;
+        std::unique_ptr<std::atomic<uint32_t>[]> m_parents; // union-find parent of every padded tile (none -> not empty)
+        std::vector<uint8_t> m_inRegion; // 1 -> tile is in the clicked region
+        size_t m_capacity = 0; // padded tiles m_parents can hold
+        std::vector<std::vector<uint32_t>> m_opened; // tiles opened by each strip
+    };
+};
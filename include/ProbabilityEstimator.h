@@ -0,0 +1,84 @@
+// ProbabilityEstimator.h
+///////////////////////////////////////////
+#pragma once
+
+#include <Board.h>
+#include <ThreadPool.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace game
+{
+    /**
+     * @brief Monte Carlo estimate of the probability that each hidden tile is a mine
+     * Samples mine layouts consistent with the opened numbers and the mine count
+     * (flags are not trusted). Only the frontier (hidden tiles next to a number) is
+     * sampled: the interior tiles are all alike, so each frontier layout is weighted
+     * by the ways to place the remaining mines there. Every chain starts from a random
+     * consistent layout then repeatedly redraws a block of close frontier tiles
+     * among all the layouts that agree with the numbers (heat-bath Gibbs moves).
+     * Chains run as small tasks on a work-stealing pool with per-worker RNGs and
+     * add their counts with atomics, so read() can be called at any time and the
+     * estimate gets finer while the player thinks.
+     */
+    class ProbabilityEstimator
+    {
+    public:
+        /**
+         * @brief
+         *
+         * @param pool pool running the chains (must outlive the estimator)
+         */
+        explicit ProbabilityEstimator(ThreadPool& pool);
+
+        // cancels the running estimate (tasks still queued return at once)
+        ~ProbabilityEstimator();
+
+        ProbabilityEstimator(const ProbabilityEstimator&) = delete;
+        ProbabilityEstimator& operator=(const ProbabilityEstimator&) = delete;
+
+        /**
+         * @brief cancels the previous estimate and starts sampling the board as it is now
+         * O(size) copy on the calling thread, everything else runs on the pool
+         *
+         * @param board board to estimate (not used after the call)
+         * @param seed seed of the per-worker RNGs
+         */
+        void start(const Board& board, uint64_t seed = 0);
+
+        // cancels the running estimate (read() keeps returning what was sampled)
+        void stop();
+
+        // true while chains are still sampling
+        bool isRunning() const;
+
+        // layouts sampled so far (summed over chains)
+        uint32_t samples() const;
+
+        /**
+         * @brief current estimate (lock-free, can be called while sampling)
+         *
+         * @param probabilities resized to the board size: mine probability of each hidden tile,
+         *                      -1 for opened tiles or when nothing was sampled yet
+         */
+        void read(std::vector<float>& probabilities) const;
+
+        // samples taken by a task before it gives its worker back to the pool
+        static const uint32_t samplesPerTask = 32;
+        // sampling stops after this many samples (the estimate barely moves anymore)
+        static const uint32_t maxSamples = 1u << 16;
+        // samples thrown away before a chain starts counting
+        static const uint32_t burnInSamples = 16;
+        // frontier tiles redrawn together by one move (their layouts are enumerated)
+        static const uint32_t maxBlockSize = 12;
+        // backtracking steps allowed to find a chain's first layout
+        static const uint32_t maxStartSteps = 1u << 20;
+
+    private:
+        struct Snapshot;
+
+        ThreadPool& m_pool;
+        std::shared_ptr<Snapshot> m_current; // shared with the running tasks
+    };
+};
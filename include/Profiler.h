@@ -0,0 +1,187 @@
+// Profiler.h
+///////////////////////////////////////////
+#pragma once
+
+// Built with -DMINESWEEPER_PROFILER=OFF, this header only defines empty macros
+// and the timers cost nothing.
+#ifdef MINESWEEPER_PROFILER
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace game
+{
+    // parts of a frame that are timed (frame is the whole frame, the others are inside it,
+    // logic is one command handled on the game logic thread, next to the frames)
+    enum class ProfileZone : uint8_t
+    {
+        frame,
+        events,
+        updateTile,
+        hud,
+        draw,
+        display,
+        logic,
+        count
+    };
+
+    /**
+     * @brief Process-wide frame profiler
+     * Scoped timers write (zone, start, duration) into a fixed ring buffer with
+     * one atomic increment and a few relaxed stores, from any thread. The main
+     * thread collects the ring once per frame into a short history per zone
+     * (for p50/p99) and into the CSV file if one is open. Samples overwritten
+     * before being collected are counted as dropped.
+     */
+    class Profiler
+    {
+    public:
+        // time percentiles of a zone over its recent samples
+        struct Percentiles
+        {
+            double p50Ms = 0.0;
+            double p99Ms = 0.0;
+            uint32_t samples = 0;
+        };
+
+        static Profiler& instance();
+
+        Profiler(const Profiler&) = delete;
+        Profiler& operator=(const Profiler&) = delete;
+
+        // nanoseconds on the profiler clock
+        static uint64_t now()
+        {
+            return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+        /**
+         * @brief adds a sample to the ring (lock-free, any thread)
+         *
+         * @param zone timed zone
+         * @param startNs start on the profiler clock
+         * @param endNs end on the profiler clock
+         */
+        void record(ProfileZone zone, uint64_t startNs, uint64_t endNs)
+        {
+            const uint64_t ticket = m_head.fetch_add(1, std::memory_order_relaxed);
+            Slot& slot = m_slots[ticket & (ringSize - 1)];
+            // odd sequence while the slot is written, even once it holds the sample of this ticket
+            slot.sequence.store(ticket * 2 + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            slot.startNs.store(startNs, std::memory_order_relaxed);
+            slot.durationNs.store(uint32_t(std::min<uint64_t>(endNs - startNs, UINT32_MAX)), std::memory_order_relaxed);
+            slot.frame.store(m_frame.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            slot.zone.store(uint8_t(zone), std::memory_order_relaxed);
+            slot.sequence.store(ticket * 2 + 2, std::memory_order_release);
+        }
+
+        // a frame was presented (samples recorded from now on belong to the next frame)
+        void nextFrame() { m_frame.fetch_add(1, std::memory_order_relaxed); }
+
+        /**
+         * @brief moves the samples of the ring to the zone histories and the CSV file
+         * only one thread may collect (the main loop)
+         *
+         */
+        void collect();
+
+        /**
+         * @brief time percentiles of the last historySize samples of a zone
+         * call collect() first to include the latest samples
+         *
+         * @param zone timed zone
+         * @return Percentiles p50/p99 in milliseconds (samples = 0 if the zone was never timed)
+         */
+        Percentiles percentiles(ProfileZone zone) const;
+
+        /**
+         * @brief writes every collected sample to a CSV file from now on (frame, zone, start, duration)
+         *
+         * @param path CSV file (overwritten)
+         * @return false if the file couldn't be created
+         */
+        bool openCsv(const std::filesystem::path& path);
+
+        // collects the ring and flushes the CSV file (if one is open)
+        void flushCsv();
+
+        // samples written to the CSV file so far
+        uint64_t csvSamples() const { return m_csvSamples; }
+
+        // samples overwritten before they were collected
+        uint64_t dropped() const { return m_dropped; }
+
+        static const char* zoneName(ProfileZone zone);
+
+        // samples the ring holds between two collects (power of 2)
+        static const uint32_t ringSize = 1u << 14;
+        // samples per zone the percentiles are computed from
+        static const uint32_t historySize = 1024;
+
+    private:
+        Profiler();
+
+        struct Slot
+        {
+            std::atomic<uint64_t> sequence {0};
+            std::atomic<uint64_t> startNs {0};
+            std::atomic<uint32_t> durationNs {0};
+            std::atomic<uint32_t> frame {0};
+            std::atomic<uint8_t> zone {0};
+        };
+
+        struct History
+        {
+            std::vector<uint32_t> durationsNs; // ring of the last historySize durations
+            uint32_t next = 0;
+        };
+
+    private:
+        std::vector<Slot> m_slots;
+        std::atomic<uint64_t> m_head {0}; // tickets handed to the writers
+        std::atomic<uint32_t> m_frame {0};
+
+        // collecting thread only
+        uint64_t m_tail = 0; // next ticket to collect
+        uint64_t m_dropped = 0;
+        uint64_t m_startNs; // CSV times are relative to this
+        std::array<History, size_t(ProfileZone::count)> m_history;
+        std::ofstream m_csv;
+        uint64_t m_csvSamples = 0;
+    };
+
+    // times the enclosing scope
+    class ScopedTimer
+    {
+    public:
+        explicit ScopedTimer(ProfileZone zone) : m_zone(zone), m_startNs(Profiler::now()) {}
+        ~ScopedTimer() { Profiler::instance().record(m_zone, m_startNs, Profiler::now()); }
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    private:
+        ProfileZone m_zone;
+        uint64_t m_startNs;
+    };
+};
+
+#define GAME_PROFILE_CONCAT_(a, b) a##b
+#define GAME_PROFILE_CONCAT(a, b) GAME_PROFILE_CONCAT_(a, b)
+// times the rest of the enclosing scope as a zone (e.g. GAME_PROFILE_SCOPE(draw))
+#define GAME_PROFILE_SCOPE(zone) ::game::ScopedTimer GAME_PROFILE_CONCAT(profileTimer, __LINE__)(::game::ProfileZone::zone)
+
+#else
+
+#define GAME_PROFILE_SCOPE(zone) ((void)0)
+
+#endif
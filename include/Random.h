@@ -0,0 +1,80 @@
+// Random.h
+///////////////////////////////////////////
+#pragma once
+
+#include <cstdint>
+
+namespace game
+{
+    /**
+     * @brief xoshiro256** generator (fast, seedable, same sequence on every platform)
+     * state is seeded from a 64-bit seed with splitmix64
+     */
+    class Random
+    {
+    public:
+        explicit Random(uint64_t seed = 0)
+        {
+            for (auto& word : m_state)
+                word = splitmix64(seed);
+        }
+
+        uint64_t next()
+        {
+            const uint64_t result = rotl(m_state[1] * 5, 7) * 9;
+            const uint64_t t = m_state[1] << 17;
+            m_state[2] ^= m_state[0];
+            m_state[3] ^= m_state[1];
+            m_state[1] ^= m_state[2];
+            m_state[0] ^= m_state[3];
+            m_state[2] ^= t;
+            m_state[3] = rotl(m_state[3], 45);
+            return result;
+        }
+
+        /**
+         * @brief unbiased random number in [0, range) (Lemire's multiply-shift, no modulo bias)
+         *
+         * @param range number of possible values (> 0)
+         */
+        uint32_t bounded(uint32_t range)
+        {
+            uint64_t product = uint64_t(uint32_t(next() >> 32)) * range;
+            uint32_t low = uint32_t(product);
+            if (low < range)
+            {
+                // reject the few values that would make some results more likely
+                const uint32_t threshold = uint32_t(-range) % range;
+                while (low < threshold)
+                {
+                    product = uint64_t(uint32_t(next() >> 32)) * range;
+                    low = uint32_t(product);
+                }
+            }
+            return uint32_t(product >> 32);
+        }
+
+        // random float in [0, 1)
+        float uniform()
+        {
+            return float(next() >> 40) * (1.f / float(1u << 24));
+        }
+
+        // splitmix64: expands one seed into well-mixed words (also a good 64-bit hash)
+        static uint64_t splitmix64(uint64_t& state)
+        {
+            uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            return z ^ (z >> 31);
+        }
+
+    private:
+        static uint64_t rotl(uint64_t x, int k)
+        {
+            return (x << k) | (x >> (64 - k));
+        }
+
+        uint64_t m_state[4];
+    };
+};
@@ -0,0 +1,139 @@
+// Recording.h
+///////////////////////////////////////////
+#pragma once
+
+#include <Board.h>
+#include <Simulation.h>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace game
+{
+    // What a recording needs to build the same board again
+    struct RecordingHeader
+    {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t mines = 0;
+        uint64_t seed = 0; // seed Board::generate was called with
+        uint32_t safeRadius = 1;
+    };
+
+    struct RecordedAction
+    {
+        Action action;
+        uint32_t timeMs = 0; // since the game clock started
+    };
+
+    // A parsed recording
+    struct Recording
+    {
+        RecordingHeader header;
+        std::vector<RecordedAction> actions;
+        bool hasFinalState = false; // false if the game was not finished/saved properly
+        GameStatus finalStatus = GameStatus::notStarted;
+        uint64_t finalHash = 0; // see boardStateHash
+    };
+
+    /**
+     * @brief Records player actions in a compact binary log
+     * Layout: "MSRL", version, header (varints, seed as 8 bytes), then per action
+     * varint(time delta << 2 | type) and zigzag varint(tile delta from the previous action),
+     * then an end marker with the final status and state hash.
+     * Clicks close to each other in time and place take 2 bytes.
+     */
+    class Recorder
+    {
+    public:
+        // Default Constructor (You have to call start to begin a recording)
+        Recorder();
+
+        /**
+         * @brief drops the previous recording and writes the header
+         *
+         * @param header board size, mines and generation seed
+         */
+        void start(const RecordingHeader& header);
+
+        // sets the generation seed (written again, the first click decides it in no-guess mode)
+        void setSeed(uint64_t seed);
+
+        /**
+         * @brief appends one action
+         *
+         * @param action action about to be applied on the board
+         * @param timeMs game clock time in milliseconds
+         */
+        void record(const Action& action, uint32_t timeMs);
+
+        /**
+         * @brief appends the end marker and the final state of the board
+         *
+         * @param board board the actions were applied on
+         */
+        void finish(const Board& board);
+
+        /**
+         * @brief writes the recording to a file
+         *
+         * @return false if the file couldn't be written
+         */
+        bool save(const std::filesystem::path& path) const;
+
+        const std::vector<uint8_t>& bytes() const { return m_bytes; }
+        bool isFinished() const { return m_finished; }
+
+    private:
+        std::vector<uint8_t> m_bytes;
+        size_t m_seedOffset = 0; // where the 8 seed bytes are
+        uint32_t m_lastTimeMs = 0;
+        uint32_t m_lastTile = 0;
+        bool m_finished = false;
+    };
+
+    /**
+     * @brief hash of the state a replay must reproduce
+     * status, flag/open counters and the state of every safe tile (mines are opened
+     * at game end on boards that are not headless, so they're only counted by flags)
+     *
+     * @param board board to hash
+     * @return uint64_t FNV-1a hash
+     */
+    uint64_t boardStateHash(const Board& board);
+
+    /**
+     * @brief parses a recording
+     *
+     * @param data recording bytes
+     * @param size number of bytes
+     * @param recording filled with the header, actions and final state
+     * @return false if the data is not a valid recording
+     */
+    bool parseRecording(const uint8_t* data, size_t size, Recording& recording);
+
+    /**
+     * @brief reads and parses a recording file
+     *
+     * @return false if the file couldn't be read or is not a valid recording
+     */
+    bool loadRecording(const std::filesystem::path& path, Recording& recording);
+
+    struct ReplayResult
+    {
+        bool matched = false; // final status and state hash are the recorded ones
+        GameStatus status = GameStatus::notStarted;
+        uint64_t hash = 0;
+        uint64_t actions = 0;
+    };
+
+    /**
+     * @brief plays a recording again as fast as possible (first reveal generates the board)
+     *
+     * @param recording parsed recording
+     * @param board board to play on (reused between replays, headless is fastest)
+     * @return ReplayResult final state and whether it matches the recording
+     */
+    ReplayResult replay(const Recording& recording, Board& board);
+};
@@ -0,0 +1,71 @@
+// RenderScheduler.h
+///////////////////////////////////////////
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace game
+{
+    /**
+     * @brief decides when a frame has to be drawn
+     * front-end marks it dirty when something visible changes (tiles, HUD, view),
+     * and only draws (and lets the main loop sleep otherwise) when it is dirty
+     */
+    class RenderScheduler
+    {
+    public:
+        /**
+         * @param frameRate frame rate of an always-drawing loop (used to count skipped frames)
+         */
+        explicit RenderScheduler(double frameRate = 60.0)
+            : m_frameRate(frameRate)
+        {
+            reset();
+        }
+
+        // forget counters, next frame is drawn
+        void reset()
+        {
+            m_start = std::chrono::steady_clock::now();
+            m_dirty = true;
+            m_rendered = 0;
+            m_wakeups = 0;
+        }
+
+        // something visible changed
+        void markDirty() { m_dirty = true; }
+
+        // true if a frame has to be drawn
+        bool isDirty() const { return m_dirty; }
+
+        // main loop woke up (event, timer tick or end of game)
+        void wokeUp() { m_wakeups++; }
+
+        // a frame was drawn
+        void frameRendered()
+        {
+            m_dirty = false;
+            m_rendered++;
+        }
+
+        uint64_t framesRendered() const { return m_rendered; }
+
+        uint64_t wakeups() const { return m_wakeups; }
+
+        // frames an always-drawing loop would have drawn since reset() but were not drawn
+        uint64_t framesSkipped() const
+        {
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - m_start;
+            const uint64_t frames = uint64_t(elapsed.count() * m_frameRate);
+            return frames > m_rendered ? frames - m_rendered : 0;
+        }
+
+    private:
+        std::chrono::steady_clock::time_point m_start;
+        double m_frameRate;
+        bool m_dirty = true;
+        uint64_t m_rendered = 0;
+        uint64_t m_wakeups = 0;
+    };
+};
\ No newline at end of file
@@ -0,0 +1,150 @@
+// SaveFile.h
+///////////////////////////////////////////
+#pragma once
+
+#include <Board.h>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace game
+{
+    // Fixed header at the start of a save file, written field by field (little-endian after the magic):
+    // magic, version, headerSize, width, height, mines (u32), seed (u64), elapsedMs (u32), status (u8), zeros
+    struct SaveHeader
+    {
+        char magic[4] = {'M', 'S', 'S', 'V'};
+        uint32_t version = 1;
+        uint32_t headerSize = 64; // packed tiles start here
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t mines = 0;
+        uint64_t seed = 0;
+        uint32_t elapsedMs = 0; // game clock when saved
+        uint8_t status = 0; // GameStatus
+    };
+    static const uint32_t saveHeaderBytes = 64; // SaveHeader on disk
+
+    /**
+     * @brief Board saved in a memory-mapped file: fixed header + 1 packed byte per tile (Tile::pack)
+     * Opening maps the file and reads only the header. restore() reads and checks
+     * every tile once (O(tiles), no parsing or copying through a stream).
+     * update() only writes changed tiles to the mapping, the autosave thread
+     * flushes the dirty pages, so the game loop never waits for the disk.
+     */
+    class SaveFile
+    {
+    public:
+        // Default Constructor (You have to call create or open)
+        SaveFile();
+        ~SaveFile();
+
+        SaveFile(const SaveFile&) = delete;
+        SaveFile& operator=(const SaveFile&) = delete;
+
+        /**
+         * @brief creates (or overwrites) a save file holding the board
+         *
+         * @param path save file
+         * @param board board to save
+         * @param seed level seed
+         * @return false if the file couldn't be created/mapped
+         */
+        bool create(const std::filesystem::path& path, const Board& board, uint64_t seed);
+
+        /**
+         * @brief maps an existing save file (only the header is read)
+         *
+         * @return false if the file is missing, not a save file, another version or its header is corrupt
+         */
+        bool open(const std::filesystem::path& path);
+
+        /**
+         * @brief rebuilds the saved board (reads every tile)
+         *
+         * @param board board to restore
+         * @return false if the saved tiles are corrupt (see Board::restore)
+         */
+        bool restore(Board& board) const;
+
+        /**
+         * @brief writes every tile (after generate(), which changes tiles without reporting them)
+         *
+         * @param board saved board (same size)
+         */
+        void store(const Board& board);
+
+        /**
+         * @brief writes changed tiles and the header to the mapping and marks their pages dirty
+         *
+         * @param board saved board (same size)
+         * @param changedTiles tiles changed since the last update (e.g. Board::changes())
+         * @param elapsedMs game clock
+         */
+        void update(const Board& board, const std::vector<uint32_t>& changedTiles, uint32_t elapsedMs);
+
+        /**
+         * @brief flushes dirty pages on a background thread every interval
+         *
+         * @param interval time between flushes
+         */
+        void startAutosave(std::chrono::milliseconds interval);
+
+        // stops the autosave thread (after a last flush)
+        void stopAutosave();
+
+        // writes dirty pages to disk now (blocks until they are written)
+        void flush();
+
+        // flushes and unmaps the file
+        void close();
+
+        bool isOpen() const { return m_data != nullptr; }
+        const SaveHeader& header() const { return m_header; }
+
+    private:
+        /**
+         * @brief maps a file read/write (resized to size if create is true)
+         *
+         * @return false on failure (nothing stays open)
+         */
+        bool map(const std::filesystem::path& path, size_t size, bool create);
+
+        // marks the pages of a byte range dirty (m_dirtyMutex must be locked)
+        void markDirty(size_t offset, size_t length);
+
+        // flushes the given pages (sorted), merging neighbour pages
+        void flushPages(std::vector<size_t>& pages);
+
+        // writes m_header to the mapping
+        void writeHeader();
+
+        uint8_t* tiles() { return m_data + saveHeaderBytes; }
+
+    private:
+        SaveHeader m_header; // decoded copy of the header in the mapping
+        uint8_t* m_data = nullptr;
+        size_t m_size = 0;
+        size_t m_pageSize = 4096;
+#ifdef _WIN32
+        void* m_file = nullptr; // HANDLE
+        void* m_mapping = nullptr; // HANDLE
+#else
+        int m_fd = -1;
+#endif
+
+        // dirty pages, shared with the autosave thread
+        std::mutex m_dirtyMutex;
+        std::vector<bool> m_isDirty;
+        std::vector<size_t> m_dirtyPages;
+
+        std::thread m_autosave;
+        std::condition_variable m_wakeUp;
+        bool m_stopAutosave = false;
+    };
+};
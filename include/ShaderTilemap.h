@@ -0,0 +1,155 @@
+// ShaderTilemap.h
+///////////////////////////////////////////
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <vector>
+
+/**
+ * @brief draws a whole map as one quad: the GPU keeps one byte (tileset index) per tile
+ * in a "states" texture (4 tiles per RGBA texel) and a fragment shader looks the
+ * tileset up. Changing a tile uploads one texel.
+ */
+class ShaderTilemap : public sf::Drawable
+{
+public:
+    // true if the graphics driver supports shaders
+    static bool isAvailable() { return sf::Shader::isAvailable(); }
+
+    template <typename TileAt>
+    bool load(  const sf::Texture&  tileset,  /* texture/tileset (must outlive the map) */
+                sf::Vector2u        tileSize, /* tileSize in the texture*/
+                uint32_t            width,    /* map width */
+                uint32_t            height,   /* map height */
+                TileAt&&            tileAt    /* tileAt(index1D): index of a tile in the texture */)
+    {
+        // update member data
+        m_tileSize = tileSize;
+        m_width = width;
+        m_height = height;
+
+        // states texture: 4 tiles per texel, 1 row per map row
+        const sf::Vector2u statesSize((width + 3) / 4, height);
+        if (statesSize.x > sf::Texture::getMaximumSize() || statesSize.y > sf::Texture::getMaximumSize())
+            return false;
+        // shader is compiled once, the states texture is only reallocated if the map size changes
+        if (!m_shaderLoaded && !(m_shaderLoaded = m_shader.loadFromMemory(vertexShader, fragmentShader)))
+            return false;
+        if (m_states.getSize() != statesSize && !m_states.resize(statesSize))
+            return false;
+
+        // CPU copy of the texture (rows padded to whole texels)
+        m_stride = statesSize.x * 4;
+        m_cells.assign(size_t(m_stride) * height, 0);
+        for (uint32_t i = 0; i < height; ++i)
+            for (uint32_t j = 0; j < width; ++j)
+                m_cells[size_t(i) * m_stride + j] = uint8_t(tileAt(i * width + j));
+        m_states.update(m_cells.data());
+        m_dirtyTexels = 0;
+
+        m_shader.setUniform("states", m_states);
+        m_shader.setUniform("tileset", tileset);
+        m_shader.setUniform("statesSize", sf::Vector2f(statesSize));
+        m_shader.setUniform("tilesetTiles", sf::Vector2f(float(tileset.getSize().x / tileSize.x),
+                                                          float(tileset.getSize().y / tileSize.y)));
+
+        // one quad over the whole map, texture coordinates are in tiles
+        const sf::Vector2f size(float(width) * tileSize.x, float(height) * tileSize.y);
+        m_quad[0] = {{0.f, 0.f}, sf::Color::White, {0.f, 0.f}};
+        m_quad[1] = {{size.x, 0.f}, sf::Color::White, {float(width), 0.f}};
+        m_quad[2] = {{0.f, size.y}, sf::Color::White, {0.f, float(height)}};
+        m_quad[3] = {{size.x, size.y}, sf::Color::White, {float(width), float(height)}};
+        return true;
+    }
+
+    /**
+     * @brief 
+     * 
+     * @param index1D tile index in 1D map array
+     * @param tileNumber newTileIndex on the tileset
+     */
+    void updateTile(uint32_t index1D, uint16_t tileNumber)
+    {
+        const uint32_t i = index1D / m_width;
+        const uint32_t j = index1D % m_width;
+        m_cells[size_t(i) * m_stride + j] = uint8_t(tileNumber);
+
+        // upload is deferred to draw: 1 texel if only one changed, else the changed rows
+        const uint32_t texel = j / 4;
+        if (m_dirtyTexels == 0)
+        {
+            m_dirtyTexel = {texel, i};
+            m_dirtyTop = m_dirtyBottom = i;
+            m_dirtyTexels = 1;
+        }
+        else if (m_dirtyTexels == 1 && m_dirtyTexel == sf::Vector2u(texel, i))
+            return;
+        else
+        {
+            m_dirtyTop = std::min(m_dirtyTop, i);
+            m_dirtyBottom = std::max(m_dirtyBottom, i);
+            m_dirtyTexels = 2;
+        }
+    }
+
+private:
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override
+    {
+        flush();
+        states.shader = &m_shader;
+        target.draw(m_quad, 4, sf::PrimitiveType::TriangleStrip, states);
+    }
+
+    // uploads tiles changed since last draw
+    void flush() const
+    {
+        if (m_dirtyTexels == 1)
+            m_states.update(&m_cells[size_t(m_dirtyTexel.y) * m_stride + m_dirtyTexel.x * 4], {1u, 1u}, m_dirtyTexel);
+        else if (m_dirtyTexels > 1)
+            m_states.update(&m_cells[size_t(m_dirtyTop) * m_stride], {m_stride / 4, m_dirtyBottom - m_dirtyTop + 1}, {0u, m_dirtyTop});
+        m_dirtyTexels = 0;
+    }
+
+    static constexpr const char* vertexShader = R"(
+        varying vec2 tilePos; // position in tiles
+        void main()
+        {
+            gl_Position = gl_ModelViewProjectionMatrix * gl_Vertex;
+            gl_FrontColor = gl_Color;
+            tilePos = gl_MultiTexCoord0.xy;
+        }
+    )";
+
+    static constexpr const char* fragmentShader = R"(
+        uniform sampler2D states;  // tileset index of each tile, 4 tiles per texel
+        uniform sampler2D tileset;
+        uniform vec2 statesSize;   // states size in texels
+        uniform vec2 tilesetTiles; // tileset size in tiles
+        varying vec2 tilePos;
+        void main()
+        {
+            vec2 tile = floor(tilePos);
+            vec4 texel = texture2D(states, vec2(floor(tile.x / 4.0) + 0.5, tile.y + 0.5) / statesSize);
+            vec4 channel = vec4(equal(vec4(mod(tile.x, 4.0)), vec4(0.0, 1.0, 2.0, 3.0)));
+            float index = floor(dot(texel, channel) * 255.0 + 0.5);
+            vec2 tileCoords = vec2(mod(index, tilesetTiles.x), floor(index / tilesetTiles.x));
+            gl_FragColor = gl_Color * texture2D(tileset, (tileCoords + fract(tilePos)) / tilesetTiles);
+        }
+    )";
+
+
+    sf::Shader              m_shader;
+    bool                    m_shaderLoaded = false;
+    mutable sf::Texture     m_states;  // 1 byte per tile on the GPU
+    std::vector<uint8_t>    m_cells;   // CPU copy of m_states
+    sf::Vertex              m_quad[4];
+    sf::Vector2u            m_tileSize;
+    uint32_t                m_width = 0;
+    uint32_t                m_height = 0;
+    uint32_t                m_stride = 0; // bytes per row of m_cells
+    // tiles changed since last draw
+    mutable uint32_t        m_dirtyTexels = 0; // 0, 1 or more
+    mutable sf::Vector2u    m_dirtyTexel;
+    mutable uint32_t        m_dirtyTop = 0;
+    mutable uint32_t        m_dirtyBottom = 0;
+};
\ No newline at end of file
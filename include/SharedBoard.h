@@ -0,0 +1,156 @@
+// SharedBoard.h
+///////////////////////////////////////////
+#pragma once
+
+#include <Board.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace game
+{
+    // New state of a tile after an action on a SharedBoard
+    struct TileChange
+    {
+        uint32_t tileIndex1D = 0;
+        uint32_t version = 0; // state changes of the tile so far (the latest change has the biggest version)
+        TileState state = TileState::hidden;
+    };
+
+    /**
+     * @brief Board played by several threads at the same time (co-op server)
+     * Mines and counters never change once generated, tile states are atomic
+     * words (version << 8 | state) changed with a compare-and-swap: two players
+     * opening the same tile open it once, and a flood fill only spreads from the
+     * tiles it opened itself, so concurrent floods share a region without a lock.
+     * Every action returns the tiles it changed, a client that receives changes
+     * out of order keeps the one with the biggest version. Versions are 24 bits:
+     * a tile's flag can be toggled up to maxVersion - 1 times, later toggles are
+     * ignored (the last version is kept for opening the tile).
+     */
+    class SharedBoard
+    {
+    public:
+        /**
+         * @brief
+         *
+         * @param width board width in tiles
+         * @param height board height in tiles
+         * @param mines number of mines (generated on the first reveal)
+         * @param seed level seed (same as Board::generate)
+         * @param safeRadius see Board::generate
+         */
+        SharedBoard(uint32_t width, uint32_t height, uint32_t mines, uint64_t seed, uint32_t safeRadius = 1);
+
+        SharedBoard(const SharedBoard&) = delete;
+        SharedBoard& operator=(const SharedBoard&) = delete;
+
+        /**
+         * @brief opens a tile, opening its empty neighbours too (players lose on a mine)
+         * the first reveal generates the level around its tile (the others wait for it)
+         *
+         * @param tileIndex1D index in 1Dim tiles array
+         * @param changes tiles changed by this call are appended
+         * @return true if any tile changed
+         */
+        bool reveal(uint32_t tileIndex1D, std::vector<TileChange>& changes);
+
+        /**
+         * @brief sets/unsets a flag on a hidden tile (ignored before the first reveal)
+         * when all flags are used the game ends (win only if all flags are on mines)
+         *
+         * @param tileIndex1D index in 1Dim tiles array
+         * @param changes tiles changed by this call are appended
+         * @return true if the flag was set/unset
+         */
+        bool toggleFlag(uint32_t tileIndex1D, std::vector<TileChange>& changes);
+
+        /**
+         * @brief opens all non-flagged neighbours if number of flagged neighbours >= number of tile
+         * players lose if one of these flags is not on a mine
+         *
+         * @param tileIndex1D an opened tile
+         * @param changes tiles changed by this call are appended
+         * @return true if neighbours were opened (or players lost)
+         */
+        bool chord(uint32_t tileIndex1D, std::vector<TileChange>& changes);
+
+        /**
+         * @brief state of every tile that changed since the game started
+         * taken tile by tile while others play (a change made meanwhile may be missing,
+         * it is in the changes of its action)
+         *
+         * @param tiles filled with the changed tiles
+         */
+        void snapshot(std::vector<TileChange>& tiles) const;
+
+        // tile opened first (the level is generated around it), noTile before the first reveal
+        uint32_t firstClick() const { return status() == GameStatus::notStarted ? noTile : m_firstClick; }
+        GameStatus status() const { return m_status.load(std::memory_order_acquire); }
+        bool isFinished() const { return status() == GameStatus::won || status() == GameStatus::lost; }
+        uint32_t width() const { return m_width; }
+        uint32_t height() const { return m_height; }
+        uint32_t size() const { return m_width * m_height; }
+        uint32_t mines() const { return m_mines; }
+        uint64_t seed() const { return m_seed; }
+        uint32_t safeRadius() const { return m_safeRadius; }
+        uint32_t flags() const { return m_flags.load(std::memory_order_relaxed); }
+        uint32_t revealedSafe() const { return m_revealedSafe.load(std::memory_order_relaxed); }
+
+        static const uint32_t noTile = UINT32_MAX;
+        static const uint32_t maxVersion = (1u << 24) - 1; // versions take the 24 high bits of a tile word
+
+    private:
+        // index of a tile in the padded storage
+        uint32_t paddedIndex(uint32_t tileIndex1D) const
+        {
+            return tileIndex1D + 2 * (tileIndex1D / m_width) + m_stride + 1;
+        }
+
+        // generates the level around the first revealed tile (once)
+        void start(uint32_t firstClick);
+
+        /**
+         * @brief changes a tile from one state to another (fails if another thread changed it first)
+         *
+         * @param word tile word read before (version << 8 | state)
+         * @return true if this call changed it
+         */
+        bool changeState(uint32_t tileIndex1D, uint32_t padded, uint32_t word, TileState state,
+                         std::vector<TileChange>& changes);
+
+        /**
+         * @brief opens a hidden non-mined tile if no other thread did
+         *
+         * @return true if this call opened it
+         */
+        bool openTile(uint32_t tileIndex1D, uint32_t padded, std::vector<TileChange>& changes);
+
+        // opens hidden neighbours of every empty tile opened from changes[queueHead] on
+        void unhideEmptyNeighbours(size_t queueHead, std::vector<TileChange>& changes);
+
+        // first call decides how the game ends
+        void endGame(bool userWon);
+
+    private:
+        std::vector<Tile> m_tiles; // mines and counters with a border of sentinels (states are in m_words)
+        std::unique_ptr<std::atomic<uint32_t>[]> m_words; // version << 8 | state of every padded tile
+        uint32_t m_stride = 0; // padded row length (width + 2)
+        int32_t m_paddedOffsets[8] = {}; // neighbourSteps in the padded storage
+        int32_t m_offsets[8] = {}; // neighbourSteps in tile indices
+        uint32_t m_width = 0;
+        uint32_t m_height = 0;
+        uint32_t m_mines = 0;
+        uint64_t m_seed = 0;
+        uint32_t m_safeRadius = 1;
+        uint32_t m_firstClick = noTile; // written once before m_status becomes playing
+        std::once_flag m_started;
+        std::atomic<GameStatus> m_status {GameStatus::notStarted};
+        std::atomic<uint32_t> m_flags {0};
+        std::atomic<uint32_t> m_correctFlags {0};
+        std::atomic<uint32_t> m_wrongFlags {0};
+        std::atomic<uint32_t> m_revealedSafe {0};
+    };
+};
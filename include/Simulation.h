@@ -0,0 +1,66 @@
+// Simulation.h
+///////////////////////////////////////////
+#pragma once
+
+#include <Board.h>
+#include <cstdint>
+#include <vector>
+
+namespace game
+{
+    // Action a player (or a script) can do on a board
+    enum class ActionType : char // 1-byte
+    {
+        reveal, flag, chord
+    };
+
+    struct Action
+    {
+        ActionType type = ActionType::reveal;
+        uint32_t tileIndex1D = 0;
+    };
+
+    // Batch of headless games that all play the same script on differently seeded boards
+    struct SimulationConfig
+    {
+        uint32_t width = 16;
+        uint32_t height = 16;
+        uint32_t mines = 40;
+        uint64_t games = 1;
+        uint64_t seed = 0; // game i is generated with seed + i
+        uint32_t safeRadius = 1; // see Board::generate
+        std::vector<Action> script; // first action should be a reveal (it generates the level)
+    };
+
+    struct SimulationResult
+    {
+        uint64_t games = 0;
+        uint64_t won = 0;
+        uint64_t lost = 0;
+        uint64_t unfinished = 0; // script ended before the game did
+        uint64_t actions = 0; // actions applied (actions after game end are skipped)
+    };
+
+    /**
+     * @brief applies one action on a board
+     *
+     * @return true if board changed
+     */
+    bool apply(Board& board, const Action& action);
+
+    /**
+     * @brief plays config.games games on one thread, reusing one board
+     *
+     * @param config board size, seeds and the script every game plays
+     * @return SimulationResult counters of how games ended
+     */
+    SimulationResult simulate(const SimulationConfig& config);
+
+    /**
+     * @brief builds a script of random reveals (plus a chord after each one)
+     *
+     * @param length number of reveals
+     * @param seed random seed
+     */
+    std::vector<Action> randomScript(uint32_t width, uint32_t height, uint32_t length, uint64_t seed);
+};
@@ -0,0 +1,115 @@
+// Solver.h
+///////////////////////////////////////////
+#pragma once
+
+#include <Board.h>
+#include <cstdint>
+#include <vector>
+
+namespace game
+{
+    // What the solver proved about a tile
+    enum class Knowledge : char // 1-byte
+    {
+        unknown, safe, mine
+    };
+
+    // A tile the solver proved safe (to open) or mined (to flag)
+    struct Hint
+    {
+        uint32_t tileIndex1D = 0;
+        bool isMine = false;
+    };
+
+    /**
+     * @brief Deterministic minesweeper solver working only from opened tiles (flags are not trusted)
+     * Deductions: single-tile rules, subset rules between close numbers and exact
+     * enumeration of frontier components. It is incremental: update() only
+     * re-examines numbers next to tiles that changed.
+     */
+    class Solver
+    {
+    public:
+        // Default Constructor (You have to call reset to attach a board)
+        Solver();
+
+        /**
+         * @brief attaches to a board and forgets all deductions
+         *
+         * @param board board to solve (must outlive the solver or the next reset)
+         */
+        void reset(const Board& board);
+
+        /**
+         * @brief re-examines numbers around changed tiles (call after every board action)
+         *
+         * @param changedTiles tiles whose state changed (e.g. Board::changes() or Board::revealed())
+         */
+        void update(const std::vector<uint32_t>& changedTiles);
+
+        /**
+         * @brief next deduction that is still useful: a hidden safe tile first, then an unflagged mine
+         *
+         * @param hint filled with the deduction
+         * @return false if nothing is known
+         */
+        bool hint(Hint& hint);
+
+        Knowledge knowledge(uint32_t tileIndex1D) const { return m_known[tileIndex1D]; }
+
+        // frontier components bigger than this are not enumerated (exponential)
+        static const uint32_t maxComponentSize = 48;
+        // backtracking steps allowed per component before giving up
+        static const uint32_t maxEnumerationSteps = 1u << 18;
+
+    private:
+        // true if the tile is opened (a constraint)
+        bool isOpened(uint32_t tileIndex1D) const { return isOpened(m_board->tile(tileIndex1D)); }
+        static bool isOpened(const Tile& tile);
+
+        // queues a constraint (opened tile) to be examined
+        void enqueue(uint32_t tileIndex1D);
+
+        // queues opened neighbours of a tile (their constraint changed)
+        void enqueueNeighbours(uint32_t tileIndex1D);
+
+        // stores a deduction and queues the constraints around it
+        void setKnown(uint32_t tileIndex1D, Knowledge knowledge);
+
+        /**
+         * @brief unknown hidden neighbours of a number and the mines still missing around it
+         *
+         * @param tileIndex1D opened tile
+         * @param unknown array of indices (PLEASE MAKE SURE THAT THIS IS ALLOCATED IN MEMORY -- 8)
+         * @param unknownCount number of unknown neighbours found
+         * @return int number of mines among the unknown neighbours
+         */
+        int constraint(uint32_t tileIndex1D, uint32_t* unknown, uint32_t& unknownCount) const;
+
+        // single-tile and subset rules on one number
+        void examine(uint32_t tileIndex1D);
+
+        // exact enumeration of frontier components containing dirty tiles
+        void enumerateDirtyComponents();
+
+        // enumerates one component starting from a frontier tile
+        void enumerateComponent(uint32_t start);
+
+    private:
+        const Board* m_board = nullptr;
+        std::vector<Knowledge> m_known; // deductions (opened tiles are safe)
+        std::vector<uint32_t> m_queue; // numbers to examine
+        std::vector<bool> m_queued;
+        std::vector<uint32_t> m_dirty; // frontier tiles whose component must be enumerated again
+        std::vector<bool> m_isDirty;
+        std::vector<uint32_t> m_safe; // deduced safe tiles (some may be opened since)
+        std::vector<uint32_t> m_mines; // deduced mines
+
+        // enumeration buffers (reused)
+        std::vector<uint32_t> m_component;
+        std::vector<int32_t> m_variable; // tile -> index in m_component (-1 if not in it)
+        std::vector<uint32_t> m_enumerated; // tiles of components enumerated in this pass
+        std::vector<uint32_t> m_constraints; // numbers around m_component
+        std::vector<bool> m_inComponent; // number -> already in m_constraints
+    };
+};
@@ -0,0 +1,95 @@
+// SpscQueue.h
+///////////////////////////////////////////
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace game
+{
+    /**
+     * @brief Bounded lock-free queue for one producer thread and one consumer thread
+     * A ring of capacity slots (power of 2) with a head written only by the consumer
+     * and a tail written only by the producer: push and pop are one acquire load
+     * and one release store each. The indices live on separate cache lines so the
+     * two threads don't invalidate each other's line on every item.
+     */
+    template <typename T>
+    class SpscQueue
+    {
+    public:
+        /**
+         * @brief
+         *
+         * @param capacity items the queue can hold (rounded up to a power of 2)
+         */
+        explicit SpscQueue(size_t capacity)
+        {
+            size_t size = 1;
+            while (size < capacity)
+                size *= 2;
+            m_mask = size - 1;
+            m_items.reset(new T[size]);
+        }
+
+        SpscQueue(const SpscQueue&) = delete;
+        SpscQueue& operator=(const SpscQueue&) = delete;
+
+        // producer: false if the queue is full (item not added)
+        bool tryPush(const T& item)
+        {
+            const size_t tail = m_tail.load(std::memory_order_relaxed);
+            if (tail - m_cachedHead > m_mask)
+            {
+                // the consumer's head is only read again when the queue looks full
+                m_cachedHead = m_head.load(std::memory_order_acquire);
+                if (tail - m_cachedHead > m_mask)
+                    return false;
+            }
+            m_items[tail & m_mask] = item;
+            m_tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        // consumer: false if the queue is empty
+        bool tryPop(T& item)
+        {
+            const size_t head = m_head.load(std::memory_order_relaxed);
+            if (head == m_cachedTail)
+            {
+                m_cachedTail = m_tail.load(std::memory_order_acquire);
+                if (head == m_cachedTail)
+                    return false;
+            }
+            item = m_items[head & m_mask];
+            m_head.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        // either thread (a snapshot, the other thread may change it meanwhile)
+        bool empty() const
+        {
+            return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+        }
+
+        // consumer only, when the producer is stopped
+        void clear()
+        {
+            // the cached tail goes with the head: tryPop must not see the dropped items as still there
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            m_head.store(m_cachedTail, std::memory_order_release);
+        }
+
+        size_t capacity() const { return m_mask + 1; }
+
+    private:
+        std::unique_ptr<T[]> m_items;
+        size_t m_mask = 0;
+        alignas(64) std::atomic<size_t> m_head {0}; // next item to pop (written by the consumer)
+        size_t m_cachedTail = 0; // consumer's last read of m_tail
+        alignas(64) std::atomic<size_t> m_tail {0}; // next free slot (written by the producer)
+        size_t m_cachedHead = 0; // producer's last read of m_head
+    };
+};
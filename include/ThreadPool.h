@@ -0,0 +1,80 @@
+// ThreadPool.h
+///////////////////////////////////////////
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace game
+{
+    /**
+     * @brief Work-stealing thread pool
+     * Every worker has its own task deque: it pops its newest task, idle workers
+     * steal the oldest task of another worker. Tasks submitted from a worker go
+     * to its own deque (resubmitting tasks stay on the same thread).
+     */
+    class ThreadPool
+    {
+    public:
+        /**
+         * @brief starts the workers
+         *
+         * @param threads number of workers (0 -> one per core, minus the calling thread)
+         */
+        explicit ThreadPool(uint32_t threads = 0);
+
+        // drops queued tasks and joins the workers (running tasks finish first)
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        void submit(std::function<void()> task);
+
+        /**
+         * @brief like submit, but from a worker the task goes behind the tasks already queued
+         * on it (front of its deque: the worker runs it last, idle workers steal it first),
+         * so a task that keeps resubmitting itself doesn't hold its worker
+         */
+        void defer(std::function<void()> task);
+
+        uint32_t size() const { return uint32_t(m_workers.size()); }
+
+        // index of the worker running the calling thread (size() if not a worker of this pool)
+        uint32_t currentWorker() const;
+
+    private:
+        struct Worker
+        {
+            std::mutex mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        // queues a task on the current worker (round robin from outside), at the front of its deque if last
+        void push(std::function<void()> task, bool last);
+
+        // worker thread loop
+        void run(uint32_t worker);
+
+        // own newest task, or another worker's oldest one
+        bool take(uint32_t worker, std::function<void()>& task);
+
+    private:
+        std::vector<std::unique_ptr<Worker>> m_workers;
+        std::vector<std::thread> m_threads;
+        std::atomic<uint32_t> m_nextWorker {0}; // round robin for tasks submitted from outside
+        // queued tasks; signed: a worker may take a task before submit counts it (-1 until then)
+        std::atomic<int64_t> m_pending {0};
+
+        std::mutex m_sleepMutex;
+        std::condition_variable m_wakeUp;
+        bool m_stop = false;
+    };
+};
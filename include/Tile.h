@@ -1,6 +1,8 @@
 // Tile.h
 #pragma once
 
+#include <cstdint>
+
 namespace game
 {
 
@@ -13,22 +15,33 @@ namespace game
         hidden, flag, mine, mineClicked
     };
 
-    // State of each tile
-    enum class TileState : char // 1-byte
+    // State of each tile (sentinel: border tile around the board, never shown nor saved)
+    enum class TileState : uint8_t // 3-bits in a Tile
     {
-        hidden, notHidden, flagged, peek, mineClicked
+        hidden, notHidden, flagged, peek, mineClicked, sentinel
     };
 
-    // should be 4-bytes
+    // 1-byte (bit-fields): counter 0-8, mine, state
     struct Tile 
     {
     public:
-        short m_mineCounter = 0; // 2-bytes
-        bool  m_isMine = 0; // 1-byte
-        TileState m_state = TileState::hidden; // 1-byte
+        uint8_t   m_mineCounter : 4; // 4-bits
+        bool      m_isMine : 1; // 1-bit
+        TileState m_state : 3; // 3-bits
+
+        Tile() : m_mineCounter(0), m_isMine(false), m_state(TileState::hidden) {}
 
+        // looked up in a table of all 256 packed tiles
         mapIndex getMapIndex() const;
         static mapIndex getMapIndex(const Tile& tile);
+
+        // 1-byte form (save files, map index table): bits 0-3 counter, bit 4 mine, bits 5-7 state
+        uint8_t pack() const
+        {
+            return uint8_t(m_mineCounter) | uint8_t(m_isMine << 4) | uint8_t(uint8_t(m_state) << 5);
+        }
+        static Tile unpack(uint8_t packed);
     };
+    static_assert(sizeof(Tile) == 1, "a tile should fit in one byte");
     
 } // namespace game
\ No newline at end of file
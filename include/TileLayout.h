@@ -0,0 +1,157 @@
+// TileLayout.h
+///////////////////////////////////////////
+#pragma once
+
+#include <cstdint>
+
+namespace game
+{
+    // The 8 neighbours of a tile as column/row steps (up row, same row, down row)
+    struct NeighbourStep
+    {
+        int8_t dx;
+        int8_t dy;
+    };
+    static constexpr NeighbourStep neighbourSteps[8] = {
+        {-1, -1}, {0, -1}, {1, -1},
+        {-1,  0},          {1,  0},
+        {-1,  1}, {0,  1}, {1,  1}
+    };
+
+    // How a Board stores its tiles (tile indices are row by row either way)
+    enum class TileLayoutKind : uint8_t
+    {
+        rowMajor, // row by row: the rows above and below a tile are a whole row away
+        blocked // 8x8 blocks, block by block: most neighbours are in the same block (same or next cache line)
+    };
+
+    /**
+     * @brief Where the tiles of a width x height board live in storage
+     * The board has a one-tile border of sentinels, so the stored grid is
+     * (width + 2) x (height + 2) and x/y below are coordinates in it (tiles
+     * are at 1..width, 1..height). Neighbours are only asked for tiles inside
+     * the border, which never walk off the grid.
+     * In the blocked layout, a tile inside its block (36 of 64) has its
+     * neighbours at 8 fixed offsets like in the row-major one; a tile on the
+     * block's edge steps into the next blocks with shifts and masks only.
+     */
+    class TileLayout
+    {
+    public:
+        static const uint32_t blockShift = 3;
+        static const uint32_t blockSize = 1u << blockShift; // tiles per block side
+        static const uint32_t blockTiles = blockSize * blockSize;
+
+        /**
+         * @brief sets the layout of a board
+         *
+         * @param kind row-major or blocked
+         * @param width board width in tiles (without the border)
+         * @param height board height in tiles (without the border)
+         */
+        void reset(TileLayoutKind kind, uint32_t width, uint32_t height)
+        {
+            m_kind = kind;
+            m_width = width;
+            const uint32_t paddedWidth = width + 2;
+            const uint32_t paddedHeight = height + 2;
+            if (kind == TileLayoutKind::rowMajor)
+            {
+                m_rowStep = paddedWidth;
+                m_size = paddedWidth * paddedHeight;
+            }
+            else
+            {
+                m_blocksX = (paddedWidth + blockSize - 1) >> blockShift;
+                m_rowStep = blockSize; // inside a block
+                m_blockRowStep = m_blocksX * blockTiles;
+                m_size = m_blockRowStep * ((paddedHeight + blockSize - 1) >> blockShift);
+            }
+            for (uint32_t k = 0; k < 8; ++k)
+                m_offsets[k] = neighbourSteps[k].dy * int32_t(m_rowStep) + neighbourSteps[k].dx;
+        }
+
+        // storage index of a grid tile (x, y in the bordered grid)
+        uint32_t index(uint32_t x, uint32_t y) const
+        {
+            if (m_kind == TileLayoutKind::rowMajor)
+                return y * m_rowStep + x;
+            return ((y >> blockShift) * m_blocksX + (x >> blockShift)) * blockTiles +
+                   ((y & (blockSize - 1)) << blockShift) + (x & (blockSize - 1));
+        }
+
+        // storage index of a board tile (row by row tile index)
+        uint32_t padded(uint32_t tileIndex1D) const
+        {
+            if (m_kind == TileLayoutKind::rowMajor)
+                return tileIndex1D + 2 * (tileIndex1D / m_width) + m_rowStep + 1;
+            return index(tileIndex1D % m_width + 1, tileIndex1D / m_width + 1);
+        }
+
+        /**
+         * @brief storage indices of the 8 neighbours of a tile, in neighbourSteps order
+         *
+         * @param padded storage index of a tile inside the border
+         * @param around receives the neighbours
+         */
+        void neighbours(uint32_t padded, uint32_t (&around)[8]) const
+        {
+            // row-major, or a tile inside its block (not on the block's edge)
+            const uint32_t x = padded & (blockSize - 1);
+            const uint32_t y = (padded >> blockShift) & (blockSize - 1);
+            if (m_kind == TileLayoutKind::rowMajor || (x - 1 < blockSize - 2 && y - 1 < blockSize - 2))
+            {
+                for (uint32_t k = 0; k < 8; ++k)
+                    around[k] = padded + m_offsets[k];
+                return;
+            }
+            const uint32_t left = stepX(padded, x, false);
+            const uint32_t right = stepX(padded, x, true);
+            around[0] = stepY(left, y, false);
+            around[1] = stepY(padded, y, false);
+            around[2] = stepY(right, y, false);
+            around[3] = left;
+            around[4] = right;
+            around[5] = stepY(left, y, true);
+            around[6] = stepY(padded, y, true);
+            around[7] = stepY(right, y, true);
+        }
+
+        // tiles to allocate (blocks are whole, the tiles past the border are never used)
+        uint32_t size() const { return m_size; }
+
+        // tiles a width x height board would allocate in the biggest layout (to check it fits 32-bit indices)
+        static uint64_t maxSize(uint64_t width, uint64_t height)
+        {
+            const uint64_t blockMask = blockSize - 1;
+            return ((width + 2 + blockMask) & ~blockMask) * ((height + 2 + blockMask) & ~blockMask);
+        }
+        TileLayoutKind kind() const { return m_kind; }
+
+    private:
+        // tile left/right of a tile (blocked layout), x: its column in its block
+        uint32_t stepX(uint32_t padded, uint32_t x, bool right) const
+        {
+            if (right)
+                return x == blockSize - 1 ? padded + blockTiles - (blockSize - 1) : padded + 1;
+            return x == 0 ? padded - blockTiles + (blockSize - 1) : padded - 1;
+        }
+
+        // tile above/below a tile (blocked layout), y: its row in its block (same as of the tiles left/right)
+        uint32_t stepY(uint32_t padded, uint32_t y, bool down) const
+        {
+            if (down)
+                return y == blockSize - 1 ? padded + m_blockRowStep - (blockTiles - blockSize) : padded + blockSize;
+            return y == 0 ? padded - m_blockRowStep + (blockTiles - blockSize) : padded - blockSize;
+        }
+
+    private:
+        TileLayoutKind m_kind = TileLayoutKind::rowMajor;
+        uint32_t m_width = 0;
+        uint32_t m_rowStep = 0; // storage distance to the tile below (inside a block when blocked)
+        uint32_t m_blocksX = 0; // blocks per block row
+        uint32_t m_blockRowStep = 0; // storage size of a block row
+        uint32_t m_size = 0;
+        int32_t m_offsets[8] = {}; // neighbourSteps in storage (every tile if row-major, inside a block if blocked)
+    };
+};
@@ -2,53 +2,117 @@
 ///////////////////////////////////////////
 #pragma once
 #include <SFML/Graphics.hpp>
+#include <ShaderTilemap.h>
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <vector>
 
 class Tilemap : public sf::Drawable, public sf::Transformable
 {
 public:
+    // tiles per chunk side -- map is split in chunks and only chunks inside the view are drawn
+    static const uint32_t chunkSize = 32u;
+
     bool load(  const std::filesystem::path& tileset, /* texture/tileset filepath */
                 sf::Vector2u    tileSize, /* tileSize in the texture*/
                 const uint16_t* tiles,    /* indexes of tiles in the texture */
-                uint16_t        width,    /* map width */
-                uint16_t        height    /* map height */)
+                uint32_t        width,    /* map width */
+                uint32_t        height    /* map height */)
+    {
+        // Open texture file
+        if (!m_ownTileset.loadFromFile(tileset))
+            return false;
+        m_tileset = nullptr; // new pixels, nothing to reuse
+        return load(m_ownTileset, tileSize, tiles, width, height);
+    }
+
+    /**
+     * @brief loads the map with a texture owned elsewhere (e.g. AssetCache)
+     * reloading with the same texture, tile size and map size keeps the GPU objects
+     * and the vertices, only the tiles are rewritten
+     */
+    bool load(  const sf::Texture&  tileset,  /* texture/tileset (must outlive the map) */
+                sf::Vector2u        tileSize, /* tileSize in the texture*/
+                const uint16_t*     tiles,    /* indexes of tiles in the texture */
+                uint32_t            width,    /* map width */
+                uint32_t            height    /* map height */)
     {
+        return load(tileset, tileSize, width, height, [tiles](uint32_t index1D) { return tiles[index1D]; });
+    }
+
+    /**
+     * @brief same as above, the tiles are asked for one by one (no index array has to be built)
+     */
+    template <typename TileAt>
+    bool load(  const sf::Texture&  tileset,  /* texture/tileset (must outlive the map) */
+                sf::Vector2u        tileSize, /* tileSize in the texture*/
+                uint32_t            width,    /* map width */
+                uint32_t            height,   /* map height */
+                TileAt&&            tileAt    /* tileAt(index1D): index of a tile in the texture */)
+    {
+        const bool sameLayout = m_tileset == &tileset && m_tileSize == tileSize &&
+                                m_width == width && m_height == height;
         // update member data
+        m_tileset = &tileset;
         m_tileSize = tileSize;
         m_width = width;
-        // Open texture file
-        if (!m_tileset.loadFromFile(tileset))
-            return false;
+        m_height = height;
+
+        // 1 byte per tile on the GPU when shaders are supported
+        m_useShader = m_shaderEnabled && ShaderTilemap::isAvailable() &&
+                      m_shaderMap.load(tileset, tileSize, width, height, tileAt);
+        if (m_useShader)
+        {
+            m_chunks.clear();
+            m_chunksX = m_chunksY = 0;
+            return true;
+        }
         
-        // setup vertex array
-        m_vertices.setPrimitiveType(sf::PrimitiveType::Triangles);
-        m_vertices.resize(width * height * 6);
+        // setup chunks (6 vertices -- 2 triangles -- per tile)
+        if (!sameLayout || m_chunks.empty())
+        {
+            m_chunksX = (width + chunkSize - 1) / chunkSize;
+            m_chunksY = (height + chunkSize - 1) / chunkSize;
+            m_chunks.assign(size_t(m_chunksX) * m_chunksY, {});
+            for (uint32_t cy = 0; cy < m_chunksY; ++cy)
+                for (uint32_t cx = 0; cx < m_chunksX; ++cx)
+                    m_chunks[size_t(cy) * m_chunksX + cx].resize(size_t(chunkWidth(cx)) * chunkHeight(cy) * 6);
+        }
 
 
-        for (uint16_t i = 0; i < width * height; ++i)
-            updateTile(i, tiles[i]);
+        for (uint32_t i = 0; i < width * height; ++i)
+            updateTile(i, uint16_t(tileAt(i)));
         return true;
     }
 
     /**
      * @brief 
      * 
-     * @param i row
-     * @param j col
+     * @param index1D tile index in 1D map array
      * @param tileNumber newTileIndex on the tileset
      */
-    void updateTile(uint16_t index1D, uint16_t tileNumber)
+    void updateTile(uint32_t index1D, uint16_t tileNumber)
     {
+        if (m_useShader)
+        {
+            m_shaderMap.updateTile(index1D, tileNumber);
+            return;
+        }
+
         auto index2D = convert(index1D, m_width);
         auto& i = index2D.x;
         auto& j = index2D.y;
 
         // tile's pos on tileset
-        uint16_t tu = (tileNumber % (m_tileset.getSize().x / m_tileSize.x)) * m_tileSize.x;
-        uint16_t tv = (tileNumber / (m_tileset.getSize().x / m_tileSize.x)) * m_tileSize.y;
+        uint16_t tu = (tileNumber % (m_tileset->getSize().x / m_tileSize.x)) * m_tileSize.x;
+        uint16_t tv = (tileNumber / (m_tileset->getSize().x / m_tileSize.x)) * m_tileSize.y;
 
-        // vertices of current tile
-        sf::Vertex* triangles = &m_vertices[index1D * 6];
+        // vertices of current tile (tiles are row-major inside their chunk)
+        const uint32_t cx = j / chunkSize;
+        const uint32_t cy = i / chunkSize;
+        std::vector<sf::Vertex>& chunk = m_chunks[size_t(cy) * m_chunksX + cx];
+        sf::Vertex* triangles = &chunk[(size_t(i % chunkSize) * chunkWidth(cx) + j % chunkSize) * 6];
 
         // define current tile's vertices position
         triangles[0].position = sf::Vector2f(j * m_tileSize.x, i * m_tileSize.y); // top-left
@@ -67,14 +131,29 @@ public:
         triangles[5].texCoords = sf::Vector2f(tu + m_tileSize.x, tv); // top-right
     }
 
+    // map size in pixels (before transform)
+    sf::Vector2f getPixelSize() const
+    {
+        return {float(m_width) * m_tileSize.x, float(m_height) * m_tileSize.y};
+    }
+
+    // use ShaderTilemap when available (takes effect on next load)
+    void setShaderEnabled(bool enabled) { m_shaderEnabled = enabled; }
+
+    // true if the map is drawn by ShaderTilemap instead of vertex chunks
+    bool usesShader() const { return m_useShader; }
+
+    // number of chunks submitted by the last draw
+    uint32_t getChunksDrawn() const { return m_chunksDrawn; }
+
 
     // convert 1D index to 2D index
-    static sf::Vector2u convert(uint16_t index1D, uint16_t width)
+    static sf::Vector2u convert(uint32_t index1D, uint32_t width)
     {
         return {(unsigned int)(index1D / width), (unsigned int)(index1D % width)};
     }
 
-    static uint16_t convert(const sf::Vector2u& index2D, uint16_t width)
+    static uint32_t convert(const sf::Vector2u& index2D, uint32_t width)
     {
         return index2D.y + index2D.x * width;
     }
@@ -83,16 +162,70 @@ private:
     void draw(sf::RenderTarget& target, sf::RenderStates states) const override
     {
         // apply the transform
-        states.transform = getTransform();
+        states.transform *= getTransform();
+        // one quad + shader, no vertices
+        if (m_useShader)
+        {
+            target.draw(m_shaderMap, states);
+            m_chunksDrawn = 1;
+            return;
+        }
+
         // apply the texture
-        states.texture = &m_tileset;
-        // draw the vertex array
-        target.draw(m_vertices, states);
+        states.texture = m_tileset;
+
+        // visible area of the map (view rectangle in map's local coordinates)
+        const sf::View& view = target.getView();
+        const sf::Transform toLocal = states.transform.getInverse();
+        const sf::Vector2f corner1 = toLocal.transformPoint(view.getCenter() - view.getSize() / 2.f);
+        const sf::Vector2f corner2 = toLocal.transformPoint(view.getCenter() + view.getSize() / 2.f);
+
+        // chunks intersecting the visible area
+        const float chunkPixelsX = float(chunkSize) * m_tileSize.x;
+        const float chunkPixelsY = float(chunkSize) * m_tileSize.y;
+        const uint32_t firstX = chunkIndex(std::min(corner1.x, corner2.x) / chunkPixelsX, m_chunksX);
+        const uint32_t lastX = chunkIndex(std::max(corner1.x, corner2.x) / chunkPixelsX, m_chunksX);
+        const uint32_t firstY = chunkIndex(std::min(corner1.y, corner2.y) / chunkPixelsY, m_chunksY);
+        const uint32_t lastY = chunkIndex(std::max(corner1.y, corner2.y) / chunkPixelsY, m_chunksY);
+
+        // draw the visible vertex arrays
+        m_chunksDrawn = 0;
+        if (m_chunks.empty())
+            return;
+        for (uint32_t cy = firstY; cy <= lastY; ++cy)
+        {
+            for (uint32_t cx = firstX; cx <= lastX; ++cx)
+            {
+                const std::vector<sf::Vertex>& chunk = m_chunks[size_t(cy) * m_chunksX + cx];
+                target.draw(chunk.data(), chunk.size(), sf::PrimitiveType::Triangles, states);
+                m_chunksDrawn++;
+            }
+        }
     }
 
+    // chunk containing a position given in chunks, clamped to the map
+    static uint32_t chunkIndex(float position, uint32_t chunks)
+    {
+        if (!(position > 0.f) || chunks == 0)
+            return 0;
+        return std::min(uint32_t(std::min(position, float(chunks - 1))), chunks - 1);
+    }
+
+    // width/height of a chunk in tiles (last chunks may be smaller)
+    uint32_t chunkWidth(uint32_t cx) const { return std::min(chunkSize, m_width - cx * chunkSize); }
+    uint32_t chunkHeight(uint32_t cy) const { return std::min(chunkSize, m_height - cy * chunkSize); }
+
 
-    sf::VertexArray m_vertices;
-    sf::Texture     m_tileset;
+    std::vector<std::vector<sf::Vertex>> m_chunks; // vertices of each chunk, row-major chunks
+    ShaderTilemap   m_shaderMap;
+    bool            m_shaderEnabled = true;
+    bool            m_useShader = false;
+    const sf::Texture* m_tileset = nullptr; // m_ownTileset or a shared texture
+    sf::Texture     m_ownTileset; // tileset loaded from a path
     sf::Vector2u    m_tileSize;
-    uint16_t        m_width;
+    uint32_t        m_width = 0;
+    uint32_t        m_height = 0;
+    uint32_t        m_chunksX = 0;
+    uint32_t        m_chunksY = 0;
+    mutable uint32_t m_chunksDrawn = 0;
 };
\ No newline at end of file
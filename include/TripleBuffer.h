@@ -0,0 +1,55 @@
+// TripleBuffer.h
+///////////////////////////////////////////
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace game
+{
+    /**
+     * @brief Latest value handed from one writer thread to one reader thread, lock-free
+     * The writer fills its back buffer and swaps it with the middle one, the reader
+     * swaps the middle one with its front buffer when it holds a newer value. Neither
+     * side ever waits, the reader skips values it was too slow to see. Buffers are
+     * reused, so values holding vectors stop allocating once they have grown.
+     */
+    template <typename T>
+    class TripleBuffer
+    {
+    public:
+        // writer: the buffer to fill (what it holds is a value published two swaps ago)
+        T& back() { return m_buffers[m_back]; }
+
+        // writer: makes back() the latest value
+        void publish()
+        {
+            m_back = m_middle.exchange(m_back | freshBit, std::memory_order_acq_rel) & indexMask;
+        }
+
+        /**
+         * @brief reader: takes the latest value if there is a new one
+         *
+         * @return true if front() changed
+         */
+        bool update()
+        {
+            if ((m_middle.load(std::memory_order_relaxed) & freshBit) == 0)
+                return false;
+            m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & indexMask;
+            return true;
+        }
+
+        // reader: the value taken by the last update
+        const T& front() const { return m_buffers[m_front]; }
+
+    private:
+        static const uint8_t indexMask = 3;
+        static const uint8_t freshBit = 4; // middle buffer was published and not read yet
+
+        T m_buffers[3];
+        uint8_t m_back = 0; // writer only
+        std::atomic<uint8_t> m_middle {1};
+        uint8_t m_front = 2; // reader only
+    };
+};
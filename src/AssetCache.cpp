@@ -0,0 +1,86 @@
+// AssetCache.cpp
+#include <AssetCache.h>
+
+namespace game
+{
+    AssetCache& AssetCache::instance()
+    {
+        static AssetCache cache;
+        return cache;
+    }
+
+    /**
+     * @brief starts reading and decoding files in the background
+     *
+     */
+    void AssetCache::preload(const std::vector<std::filesystem::path>& images, const std::vector<std::filesystem::path>& fonts)
+    {
+        for (const std::filesystem::path& path : images)
+            imageFuture(path);
+        for (const std::filesystem::path& path : fonts)
+            fontFuture(path);
+    }
+
+    // decoded image (waits for its preload)
+    const sf::Image* AssetCache::image(const std::filesystem::path& path)
+    {
+        return imageFuture(path).get().get();
+    }
+
+    // GPU texture of an image, uploaded on first use
+    const sf::Texture* AssetCache::texture(const std::filesystem::path& path)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            const auto cached = m_textures.find(path);
+            if (cached != m_textures.end())
+                return cached->second.get();
+        }
+        // upload outside the lock (decoding may still be running)
+        std::unique_ptr<sf::Texture> texture;
+        if (const sf::Image* pixels = image(path))
+        {
+            texture = std::make_unique<sf::Texture>();
+            if (!texture->loadFromImage(*pixels))
+                texture.reset();
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_textures.emplace(path, std::move(texture)).first->second.get();
+    }
+
+    // opened font (waits for its preload)
+    const sf::Font* AssetCache::font(const std::filesystem::path& path)
+    {
+        return fontFuture(path).get().get();
+    }
+
+    // future of an image, decoded on a background thread if it isn't cached yet
+    AssetCache::ImageFuture AssetCache::imageFuture(const std::filesystem::path& path)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ImageFuture& future = m_images[path];
+        if (!future.valid())
+        {
+            future = std::async(std::launch::async, [path]() {
+                auto image = std::make_shared<sf::Image>();
+                return image->loadFromFile(path) ? std::shared_ptr<const sf::Image>(image) : nullptr;
+            }).share();
+        }
+        return future;
+    }
+
+    // future of a font, opened on a background thread if it isn't cached yet
+    AssetCache::FontFuture AssetCache::fontFuture(const std::filesystem::path& path)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        FontFuture& future = m_fonts[path];
+        if (!future.valid())
+        {
+            future = std::async(std::launch::async, [path]() {
+                auto font = std::make_shared<sf::Font>();
+                return font->openFromFile(path) ? std::shared_ptr<const sf::Font>(font) : nullptr;
+            }).share();
+        }
+        return future;
+    }
+};
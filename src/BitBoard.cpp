@@ -0,0 +1,344 @@
+// BitBoard.cpp
+#include <BitBoard.h>
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    #define GAME_HAS_X86 1
+    #include <immintrin.h>
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+        #define GAME_TARGET_AVX2
+    #else
+        #define GAME_TARGET_AVX2 __attribute__((target("avx2")))
+    #endif
+#endif
+
+namespace game
+{
+    namespace
+    {
+        // adds one bitmap to the bit-sliced counter (s0 = bit 0 .. s3 = bit 3)
+        inline void add(uint64_t a, uint64_t& s0, uint64_t& s1, uint64_t& s2, uint64_t& s3)
+        {
+            uint64_t carry = s0 & a;
+            s0 ^= a;
+            uint64_t carry2 = s1 & carry;
+            s1 ^= carry;
+            s3 |= s2 & carry2;
+            s2 ^= carry2;
+        }
+
+        // count kernel: processes one row, words [0, words) of up/mid/down rows
+        using RowKernel = void (*)(const uint64_t* up, const uint64_t* mid, const uint64_t* down,
+                                   uint64_t* s0, uint64_t* s1, uint64_t* s2, uint64_t* s3, uint32_t words);
+
+        void countRowScalar(const uint64_t* up, const uint64_t* mid, const uint64_t* down,
+                            uint64_t* s0, uint64_t* s1, uint64_t* s2, uint64_t* s3, uint32_t words)
+        {
+            for (uint32_t k = 0; k < words; ++k)
+            {
+                uint64_t c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+                const uint64_t* rows[3] = {up, mid, down};
+                for (uint32_t r = 0; r < 3; ++r)
+                {
+                    const uint64_t* word = rows[r] + k;
+                    // neighbour on the left (column - 1) and on the right (column + 1)
+                    const uint64_t left = (word[0] << 1) | (word[-1] >> 63);
+                    const uint64_t right = (word[0] >> 1) | (word[1] << 63);
+                    add(left, c0, c1, c2, c3);
+                    add(right, c0, c1, c2, c3);
+                    if (r != 1)
+                        add(word[0], c0, c1, c2, c3);
+                }
+                s0[k] = c0;
+                s1[k] = c1;
+                s2[k] = c2;
+                s3[k] = c3;
+            }
+        }
+
+#ifdef GAME_HAS_X86
+        GAME_TARGET_AVX2
+        inline void add(__m256i a, __m256i& s0, __m256i& s1, __m256i& s2, __m256i& s3)
+        {
+            __m256i carry = _mm256_and_si256(s0, a);
+            s0 = _mm256_xor_si256(s0, a);
+            __m256i carry2 = _mm256_and_si256(s1, carry);
+            s1 = _mm256_xor_si256(s1, carry);
+            s3 = _mm256_or_si256(s3, _mm256_and_si256(s2, carry2));
+            s2 = _mm256_xor_si256(s2, carry2);
+        }
+
+        GAME_TARGET_AVX2
+        void countRowAvx2(const uint64_t* up, const uint64_t* mid, const uint64_t* down,
+                          uint64_t* s0, uint64_t* s1, uint64_t* s2, uint64_t* s3, uint32_t words)
+        {
+            // rows are padded to a multiple of 4 words (+ 1 zero word on each side)
+            for (uint32_t k = 0; k < words; k += 4)
+            {
+                __m256i c0 = _mm256_setzero_si256(), c1 = c0, c2 = c0, c3 = c0;
+                const uint64_t* rows[3] = {up, mid, down};
+                for (uint32_t r = 0; r < 3; ++r)
+                {
+                    const uint64_t* word = rows[r] + k;
+                    // unaligned loads of the previous/next word give the carries across words
+                    const __m256i cur = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(word));
+                    const __m256i prev = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(word - 1));
+                    const __m256i next = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(word + 1));
+                    const __m256i left = _mm256_or_si256(_mm256_slli_epi64(cur, 1), _mm256_srli_epi64(prev, 63));
+                    const __m256i right = _mm256_or_si256(_mm256_srli_epi64(cur, 1), _mm256_slli_epi64(next, 63));
+                    add(left, c0, c1, c2, c3);
+                    add(right, c0, c1, c2, c3);
+                    if (r != 1)
+                        add(cur, c0, c1, c2, c3);
+                }
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(s0 + k), c0);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(s1 + k), c1);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(s2 + k), c2);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(s3 + k), c3);
+            }
+        }
+#endif
+
+        // spreads 8 bits to the lowest bit of 8 bytes (bit i -> byte i)
+        struct SpreadTable
+        {
+            uint64_t bytes[256];
+            SpreadTable()
+            {
+                for (uint32_t bits = 0; bits < 256; ++bits)
+                {
+                    bytes[bits] = 0;
+                    for (uint32_t i = 0; i < 8; ++i)
+                        bytes[bits] |= uint64_t((bits >> i) & 1) << (i * 8);
+                }
+            }
+        };
+        const SpreadTable spread;
+
+        inline uint32_t popcount64(uint64_t x)
+        {
+#if defined(_MSC_VER) && !defined(__clang__)
+            x = x - ((x >> 1) & 0x5555555555555555ull);
+            x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+            x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0full;
+            return uint32_t((x * 0x0101010101010101ull) >> 56);
+#else
+            return uint32_t(__builtin_popcountll(x));
+#endif
+        }
+    }
+
+    // Default Constructor (You have to call reset to set board size)
+    BitBoard::BitBoard()
+    {
+
+    }
+
+    BitBoard::BitBoard(uint32_t width, uint32_t height)
+    {
+        reset(width, height);
+    }
+
+    /**
+     * @brief clears every plane and resizes the board
+     *
+     */
+    void BitBoard::reset(uint32_t width, uint32_t height)
+    {
+        m_width = width;
+        m_height = height;
+        m_words = (width + 63) / 64;
+        // multiple of 4 words for the AVX2 kernel + 1 zero word on each side
+        m_stride = (m_words + 3) / 4 * 4 + 2;
+
+        const size_t words = size_t(height + 2) * m_stride;
+        m_mines.assign(words, 0);
+        m_revealed.assign(words, 0);
+        m_flagged.assign(words, 0);
+        for (auto& counts : m_counts)
+            counts.assign(words, 0);
+
+        // bits past the last column must stay 0 in every query
+        m_validMask.assign(m_words, ~0ull);
+        if (width % 64 != 0)
+            m_validMask.back() = (1ull << (width % 64)) - 1;
+    }
+
+    std::vector<uint64_t>& BitBoard::plane(Plane plane)
+    {
+        return plane == Plane::mines ? m_mines : plane == Plane::revealed ? m_revealed : m_flagged;
+    }
+
+    const std::vector<uint64_t>& BitBoard::plane(Plane plane) const
+    {
+        return plane == Plane::mines ? m_mines : plane == Plane::revealed ? m_revealed : m_flagged;
+    }
+
+    void BitBoard::set(Plane plane, uint32_t tileIndex1D, bool value)
+    {
+        const uint32_t row = tileIndex1D / m_width;
+        const uint32_t col = tileIndex1D % m_width;
+        uint64_t& word = this->plane(plane)[rowOffset(row) + col / 64];
+        const uint64_t bit = 1ull << (col % 64);
+        word = value ? (word | bit) : (word & ~bit);
+    }
+
+    bool BitBoard::test(Plane plane, uint32_t tileIndex1D) const
+    {
+        const uint32_t row = tileIndex1D / m_width;
+        const uint32_t col = tileIndex1D % m_width;
+        return (this->plane(plane)[rowOffset(row) + col / 64] >> (col % 64)) & 1;
+    }
+
+    /**
+     * @brief computes the number of mined neighbours of every tile at once
+     *
+     */
+    void BitBoard::computeCounts(CountKernel kernel)
+    {
+        if (kernel == CountKernel::best)
+            kernel = bestKernel();
+
+        RowKernel countRow = countRowScalar;
+#ifdef GAME_HAS_X86
+        if (kernel == CountKernel::avx2)
+            countRow = countRowAvx2;
+#endif
+
+        for (uint32_t row = 0; row < m_height; ++row)
+        {
+            const size_t offset = rowOffset(row);
+            countRow(&m_mines[rowOffset(int64_t(row) - 1)], &m_mines[offset], &m_mines[rowOffset(row + 1)],
+                     &m_counts[0][offset], &m_counts[1][offset], &m_counts[2][offset], &m_counts[3][offset],
+                     m_words);
+        }
+    }
+
+    /**
+     * @brief number of mined neighbours of a tile
+     *
+     */
+    uint8_t BitBoard::count(uint32_t tileIndex1D) const
+    {
+        const uint32_t row = tileIndex1D / m_width;
+        const uint32_t col = tileIndex1D % m_width;
+        const size_t word = rowOffset(row) + col / 64;
+        const uint32_t bit = col % 64;
+        return uint8_t(((m_counts[0][word] >> bit) & 1) | ((m_counts[1][word] >> bit) & 1) << 1 |
+                       ((m_counts[2][word] >> bit) & 1) << 2 | ((m_counts[3][word] >> bit) & 1) << 3);
+    }
+
+    /**
+     * @brief unpacks all counters to one byte per tile
+     *
+     */
+    void BitBoard::exportCounts(uint8_t* counts) const
+    {
+        for (uint32_t row = 0; row < m_height; ++row)
+        {
+            const size_t offset = rowOffset(row);
+            uint8_t* out = counts + size_t(row) * m_width;
+            for (uint32_t k = 0; k < m_words; ++k)
+            {
+                const uint64_t s0 = m_counts[0][offset + k], s1 = m_counts[1][offset + k];
+                const uint64_t s2 = m_counts[2][offset + k], s3 = m_counts[3][offset + k];
+                const uint32_t columns = std::min<uint32_t>(64, m_width - k * 64);
+                // 8 tiles at a time: one table lookup per bit of the count
+                for (uint32_t bit = 0; bit < columns; bit += 8)
+                {
+                    const uint64_t bytes = spread.bytes[(s0 >> bit) & 0xff] | spread.bytes[(s1 >> bit) & 0xff] << 1 |
+                                           spread.bytes[(s2 >> bit) & 0xff] << 2 | spread.bytes[(s3 >> bit) & 0xff] << 3;
+                    const uint32_t n = std::min<uint32_t>(8, columns - bit);
+                    if (n == 8)
+                        std::memcpy(out + k * 64 + bit, &bytes, 8);
+                    else
+                        for (uint32_t i = 0; i < n; ++i)
+                            out[k * 64 + bit + i] = uint8_t(bytes >> (i * 8));
+                }
+            }
+        }
+    }
+
+    // number of tiles set in a plane
+    uint64_t BitBoard::popcount(Plane plane) const
+    {
+        const auto& bits = this->plane(plane);
+        uint64_t count = 0;
+        for (uint32_t row = 0; row < m_height; ++row)
+        {
+            const size_t offset = rowOffset(row);
+            for (uint32_t k = 0; k < m_words; ++k)
+                count += popcount64(bits[offset + k] & m_validMask[k]);
+        }
+        return count;
+    }
+
+    // true when every non-mined tile is revealed
+    bool BitBoard::allSafeRevealed() const
+    {
+        for (uint32_t row = 0; row < m_height; ++row)
+        {
+            const size_t offset = rowOffset(row);
+            for (uint32_t k = 0; k < m_words; ++k)
+                if (~(m_mines[offset + k] | m_revealed[offset + k]) & m_validMask[k])
+                    return false;
+        }
+        return true;
+    }
+
+    // true when flags are exactly on the mines
+    bool BitBoard::flagsOnMines() const
+    {
+        for (uint32_t row = 0; row < m_height; ++row)
+        {
+            const size_t offset = rowOffset(row);
+            for (uint32_t k = 0; k < m_words; ++k)
+                if ((m_mines[offset + k] ^ m_flagged[offset + k]) & m_validMask[k])
+                    return false;
+        }
+        return true;
+    }
+
+    // true when a mined tile was revealed
+    bool BitBoard::mineRevealed() const
+    {
+        for (uint32_t row = 0; row < m_height; ++row)
+        {
+            const size_t offset = rowOffset(row);
+            for (uint32_t k = 0; k < m_words; ++k)
+                if (m_mines[offset + k] & m_revealed[offset + k] & m_validMask[k])
+                    return true;
+        }
+        return false;
+    }
+
+    // true if the CPU can run the AVX2 kernel
+    bool BitBoard::hasAvx2()
+    {
+#if defined(GAME_HAS_X86) && defined(_MSC_VER) && !defined(__clang__)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7)
+            return false;
+        __cpuid(info, 1);
+        // OS saves AVX registers (OSXSAVE + AVX)
+        if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0 || (_xgetbv(0) & 6) != 6)
+            return false;
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#elif defined(GAME_HAS_X86)
+        return __builtin_cpu_supports("avx2");
+#else
+        return false;
+#endif
+    }
+
+    // kernel that CountKernel::best resolves to on this CPU
+    CountKernel BitBoard::bestKernel()
+    {
+        static const CountKernel best = hasAvx2() ? CountKernel::avx2 : CountKernel::scalar;
+        return best;
+    }
+};
@@ -0,0 +1,525 @@
+// Board.cpp
+#include <Board.h>
+#include <BitBoard.h>
+#include <ParallelFlood.h>
+#include <Random.h>
+#include <algorithm>
+
+namespace game
+{
+    // Default Constructor (You have to call reset to set board size)
+    Board::Board()
+    {
+
+    }
+
+    Board::Board(uint32_t width, uint32_t height, uint32_t mines)
+    {
+        reset(width, height, mines);
+    }
+
+    /**
+     * @brief hides every tile, removes all mines/flags and resizes the board
+     *
+     */
+    bool Board::reset(uint32_t width, uint32_t height, uint32_t mines)
+    {
+        // indices are 32-bit, bigger boards would wrap around
+        if (!fits(width, height))
+            return false;
+        m_width = width;
+        m_height = height;
+        // first clicked tile is never a mine
+        m_mines = std::min<uint32_t>(mines, size() - 1);
+        m_flags = 0;
+        m_correctFlags = 0;
+        m_wrongFlags = 0;
+        m_revealedSafe = 0;
+        m_status = GameStatus::notStarted;
+        // hidden tiles inside a border of sentinels
+        // assign keeps the capacity, so resetting between games doesn't allocate
+        Tile sentinel;
+        sentinel.m_state = TileState::sentinel;
+        m_layout.reset(m_layoutKind, width, height);
+        m_tiles.assign(m_layout.size(), sentinel);
+        for (uint32_t row = 1; row <= height; ++row)
+        {
+            if (m_layoutKind == TileLayoutKind::rowMajor)
+                std::fill_n(m_tiles.begin() + m_layout.index(1, row), width, Tile());
+            else
+            {
+                for (uint32_t col = 1; col <= width; ++col)
+                    m_tiles[m_layout.index(col, row)] = Tile();
+            }
+        }
+        for (uint32_t k = 0; k < 8; ++k)
+            m_offsets[k] = neighbourSteps[k].dy * int32_t(width) + neighbourSteps[k].dx;
+        m_changes.clear();
+        // every tile is opened at most once, so the reveal queue never grows past size()
+        m_revealed.clear();
+        m_revealed.reserve(size());
+        m_queue.clear();
+        m_queue.reserve(size());
+        m_safeZone.clear();
+        return true;
+    }
+
+    /**
+     * @brief rebuilds a board from packed tiles
+     *
+     */
+    bool Board::restore(uint32_t width, uint32_t height, uint32_t mines, GameStatus status, const uint8_t* packedTiles)
+    {
+        if (!reset(width, height, mines) || mines >= size())
+            return false;
+        m_mines = mines;
+        m_status = status;
+        uint32_t mineTiles = 0;
+        for (uint32_t i = 0; i < size(); ++i)
+        {
+            const Tile tile = Tile::unpack(packedTiles[i]);
+            // sentinels only live in the border, the neighbour walk relies on it
+            if (tile.m_state >= TileState::sentinel || tile.m_mineCounter > 8)
+            {
+                reset(width, height, mines);
+                return false;
+            }
+            m_tiles[paddedIndex(i)] = tile;
+            mineTiles += tile.m_isMine;
+            if (tile.m_state == TileState::flagged)
+            {
+                m_flags++;
+                (tile.m_isMine ? m_correctFlags : m_wrongFlags)++;
+            }
+            else if (tile.m_state == TileState::notHidden && !tile.m_isMine)
+                m_revealedSafe++;
+        }
+
+        // mines are placed on the first click, counters must match them (flood fills and win counts trust both)
+        bool valid = mineTiles == (status == GameStatus::notStarted ? 0 : mines);
+        for (uint32_t i = 0; valid && i < size(); ++i)
+        {
+            uint32_t around = 0;
+            forEachNeighbour(i, [&around](uint32_t, const Tile& neighbour) { around += neighbour.m_isMine; });
+            valid = tile(i).m_isMine || tile(i).m_mineCounter == around;
+        }
+        if (!valid)
+            reset(width, height, mines);
+        return valid;
+    }
+
+    /**
+     * @brief puts mines in random tiles and updating their neighbours counter
+     *
+     */
+    void Board::generate(uint32_t firstClickTileIndex, uint64_t seed, uint32_t safeRadius)
+    {
+        Random random(seed);
+        const uint32_t size = this->size();
+
+        // tiles around the first click that never get a mine (sorted)
+        // the zone shrinks when there are too many mines to keep it free
+        do
+            setSafeZone(firstClickTileIndex, safeRadius);
+        while (size - m_safeZone.size() < m_mines && safeRadius-- > 0);
+
+        // big boards count neighbours in bulk from mine bitmaps instead of
+        // incrementing 8 scattered counters per mine (blocked boards have them mostly in one block)
+        const bool bulkCount = size >= bulkCountMinSize && m_layout.kind() == TileLayoutKind::rowMajor;
+        BitBoard mineBits;
+        if (bulkCount)
+            mineBits.reset(m_width, m_height);
+
+        // Floyd's sampling (equivalent to a partial Fisher-Yates shuffle): picks
+        // m_mines distinct tiles out of the tiles outside the safe zone with one
+        // random number per mine, whatever the density. m_isMine is the "already
+        // picked" set, so nothing is allocated.
+        const uint32_t candidates = size - uint32_t(m_safeZone.size());
+        for (uint32_t j = candidates - m_mines; j < candidates; ++j)
+        {
+            uint32_t mineIndex = skipSafeZone(random.bounded(j + 1));
+            uint32_t padded = paddedIndex(mineIndex);
+            if (m_tiles[padded].m_isMine)
+            {
+                mineIndex = skipSafeZone(j);
+                padded = paddedIndex(mineIndex);
+            }
+
+            m_tiles[padded].m_isMine = true;
+            // a flag put before the first click may land on a mine
+            if (m_tiles[padded].m_state == TileState::flagged)
+            {
+                m_wrongFlags--;
+                m_correctFlags++;
+            }
+            if (bulkCount)
+            {
+                mineBits.set(BitBoard::Plane::mines, mineIndex, true);
+                continue;
+            }
+            // Update neighbours' counter (sentinel counters are never read)
+            uint32_t around[8];
+            m_layout.neighbours(padded, around);
+            for (uint32_t neighbour : around)
+                m_tiles[neighbour].m_mineCounter++;
+        }
+
+        if (bulkCount)
+        {
+            mineBits.computeCounts();
+            std::vector<uint8_t> counts(size);
+            mineBits.exportCounts(counts.data());
+            for (uint32_t row = 0; row < m_height; ++row)
+            {
+                Tile* tiles = &m_tiles[m_layout.index(1, row + 1)];
+                const uint8_t* rowCounts = &counts[size_t(row) * m_width];
+                for (uint32_t col = 0; col < m_width; ++col)
+                    tiles[col].m_mineCounter = rowCounts[col];
+            }
+        }
+        m_status = GameStatus::playing;
+    }
+
+    /**
+     * @brief fills m_safeZone with the tiles within safeRadius of a tile (sorted)
+     *
+     */
+    void Board::setSafeZone(uint32_t tileIndex1D, uint32_t safeRadius)
+    {
+        const uint32_t row = tileIndex1D / m_width;
+        const uint32_t col = tileIndex1D % m_width;
+        const uint32_t top = row > safeRadius ? row - safeRadius : 0;
+        const uint32_t bottom = std::min(row + safeRadius, m_height - 1);
+        const uint32_t left = col > safeRadius ? col - safeRadius : 0;
+        const uint32_t right = std::min(col + safeRadius, m_width - 1);
+
+        m_safeZone.clear();
+        for (uint32_t i = top; i <= bottom; ++i)
+            for (uint32_t j = left; j <= right; ++j)
+                m_safeZone.push_back(i * m_width + j);
+    }
+
+    /**
+     * @brief maps an index among the tiles outside the safe zone to a tile index
+     *
+     */
+    uint32_t Board::skipSafeZone(uint32_t candidate) const
+    {
+        // most tiles are before or after the whole zone
+        if (m_safeZone.empty() || candidate < m_safeZone.front())
+            return candidate;
+        if (candidate + m_safeZone.size() > m_safeZone.back())
+            return candidate + uint32_t(m_safeZone.size());
+
+        // safe tiles are sorted, each one at or before the tile shifts it by one
+        for (uint32_t safeTile : m_safeZone)
+        {
+            if (safeTile > candidate)
+                break;
+            candidate++;
+        }
+        return candidate;
+    }
+
+    /**
+     * @brief opens a tile, opening its empty neighbours too (player loses on a mine)
+     *
+     */
+    bool Board::reveal(uint32_t tileIndex1D)
+    {
+        m_revealed.clear();
+        m_queue.clear();
+        if (m_status != GameStatus::playing)
+            return false;
+
+        const uint32_t padded = paddedIndex(tileIndex1D);
+        Tile& tile = m_tiles[padded];
+        // ignore clicking on already-openned or flagged tiles
+        if (tile.m_state == TileState::notHidden || tile.m_state == TileState::flagged)
+            return false;
+
+        // player opens a mine -> Loses
+        if (tile.m_isMine)
+        {
+            setState(tileIndex1D, padded, TileState::mineClicked);
+            endGame(false);
+            return true;
+        }
+
+        // player opens a non-mined tile (and all empty tiles connected to it)
+        openTile(tileIndex1D, padded);
+        // on a huge board, a flood fill that keeps going is probably a huge region
+        // -> it's undone and the region is opened on all cores (mostly cheaper than the flood so far)
+        // (the parallel flood walks row-major storage)
+        if (m_flood == nullptr || size() < parallelFloodMinSize || tile.m_mineCounter != 0 ||
+            m_layout.kind() != TileLayoutKind::rowMajor)
+        {
+            unhideEmptyNeighbours(0);
+            return true;
+        }
+        if (unhideEmptyNeighbours(0, size() / parallelFloodShare))
+            return true;
+        // only the tiles around the clicked one can be peeked, the parallel flood opens those anyway
+        for (uint32_t opened : m_queue)
+            m_tiles[opened].m_state = TileState::hidden;
+        m_revealedSafe -= uint32_t(m_queue.size());
+        m_queue.clear();
+        m_flood->reveal(m_tiles.data(), m_width, m_height, padded, m_revealed);
+        m_revealedSafe += uint32_t(m_revealed.size());
+        finishOpening();
+        return true;
+    }
+
+    /**
+     * @brief sets/unsets a flag on a hidden tile
+     *
+     */
+    bool Board::toggleFlag(uint32_t tileIndex1D)
+    {
+        // flags can be put before the first click too
+        if (isFinished())
+            return false;
+
+        const uint32_t padded = paddedIndex(tileIndex1D);
+        const TileState state = m_tiles[padded].m_state;
+        // unsetting a flag
+        if (state == TileState::flagged)
+        {
+            setState(tileIndex1D, padded, TileState::hidden);
+            m_flags--;
+            (m_tiles[padded].m_isMine ? m_correctFlags : m_wrongFlags)--;
+            return true;
+        }
+        // ignore right-clicking on openned tile
+        if (state != TileState::hidden && state != TileState::peek)
+            return false;
+
+        // setting a flag
+        setState(tileIndex1D, padded, TileState::flagged);
+        m_flags++;
+        (m_tiles[padded].m_isMine ? m_correctFlags : m_wrongFlags)++;
+
+        // if player uses all their flags - endGame
+        // if all flags on all mines, then win, else lose
+        if (m_flags == m_mines)
+            endGame(m_wrongFlags == 0);
+        return true;
+    }
+
+    /**
+     * @brief opens all non-flagged neighbours if number of flagged neighbours >= number of tile
+     *
+     */
+    bool Board::chord(uint32_t tileIndex1D)
+    {
+        m_revealed.clear();
+        m_queue.clear();
+        const uint32_t padded = paddedIndex(tileIndex1D);
+        if (m_status != GameStatus::playing || m_tiles[padded].m_state != TileState::notHidden)
+            return false;
+
+        uint32_t flagCounter = 0;
+        bool flagNotOnMine = false;
+
+        // check neighbours with flags (sentinels are never flagged)
+        uint32_t around[8];
+        m_layout.neighbours(padded, around);
+        for (uint32_t neighbourPadded : around)
+        {
+            const Tile& neighbour = m_tiles[neighbourPadded];
+            if (neighbour.m_state == TileState::flagged)
+            {
+                flagCounter++;
+                // if player puts a flag on a not-mined tile
+                // there's possibility that player loses
+                if (!neighbour.m_isMine)
+                    flagNotOnMine = true;
+            }
+        }
+
+        // not enough flags, player is just peeking
+        if (flagCounter < uint32_t(m_tiles[padded].m_mineCounter))
+            return false;
+
+        // a flag was on wrong tile, and the player tries to open
+        // the tile, then player loses.
+        if (flagNotOnMine)
+        {
+            endGame(false);
+            return true;
+        }
+
+        // opening non-mined neighbours
+        // since player guessed the mines by putting flags correct
+        for (uint32_t k = 0; k < 8; ++k)
+        {
+            const Tile& neighbour = m_tiles[around[k]];
+            // skip mined, flagged, already-openned tiles and sentinels
+            if (neighbour.m_isMine || (neighbour.m_state != TileState::hidden && neighbour.m_state != TileState::peek))
+                continue;
+            openTile(tileIndex1D + m_offsets[k], around[k]);
+        }
+        // if a neighbour is empty, unhide all neighbour's neighbours !
+        unhideEmptyNeighbours(0);
+        return true;
+    }
+
+    /**
+     * @brief marks hidden neighbours of a tile as peeked or back to hidden
+     *
+     */
+    void Board::peek(uint32_t tileIndex1D, bool peeking)
+    {
+        const TileState from = peeking ? TileState::hidden : TileState::peek;
+        const TileState to = peeking ? TileState::peek : TileState::hidden;
+
+        uint32_t around[8];
+        m_layout.neighbours(paddedIndex(tileIndex1D), around);
+        for (uint32_t k = 0; k < 8; ++k)
+        {
+            if (m_tiles[around[k]].m_state == from)
+                setState(tileIndex1D + m_offsets[k], around[k], to);
+        }
+    }
+
+    /**
+     * @brief sets a tile's state decided somewhere else, counters follow
+     *
+     */
+    void Board::setTileState(uint32_t tileIndex1D, TileState state)
+    {
+        const uint32_t padded = paddedIndex(tileIndex1D);
+        const Tile& tile = m_tiles[padded];
+        if (tile.m_state == state)
+            return;
+        if (tile.m_state == TileState::flagged)
+        {
+            m_flags--;
+            (tile.m_isMine ? m_correctFlags : m_wrongFlags)--;
+        }
+        else if (tile.m_state == TileState::notHidden && !tile.m_isMine)
+            m_revealedSafe--;
+        if (state == TileState::flagged)
+        {
+            m_flags++;
+            (tile.m_isMine ? m_correctFlags : m_wrongFlags)++;
+        }
+        else if (state == TileState::notHidden && !tile.m_isMine)
+            m_revealedSafe++;
+        setState(tileIndex1D, padded, state);
+    }
+
+    /**
+     * @brief ends a game decided somewhere else
+     *
+     */
+    void Board::finish(bool userWon)
+    {
+        if (!isFinished())
+            endGame(userWon);
+    }
+
+    /**
+     * @brief check if player win (O(1), from the counters)
+     *
+     */
+    bool Board::checkWin() const
+    {
+        const bool allSafeRevealed = m_status != GameStatus::notStarted && m_revealedSafe == size() - m_mines;
+        const bool allMinesFlagged = m_correctFlags == m_mines && m_wrongFlags == 0;
+        return allSafeRevealed || allMinesFlagged;
+    }
+
+    /**
+     * @brief update one tile's state
+     *
+     */
+    void Board::setState(uint32_t tileIndex1D, uint32_t padded, TileState state)
+    {
+        m_tiles[padded].m_state = state;
+        if (!m_headless)
+            m_changes.push_back(tileIndex1D);
+    }
+
+    /**
+     * @brief opens one hidden non-mined tile and queues it for unhideEmptyNeighbours
+     *
+     */
+    void Board::openTile(uint32_t tileIndex1D, uint32_t padded)
+    {
+        m_tiles[padded].m_state = TileState::notHidden;
+        m_revealed.push_back(tileIndex1D);
+        m_queue.push_back(padded);
+        m_revealedSafe++;
+    }
+
+    /**
+     * @brief opens hidden neighbours of every empty tile in the reveal queue (breadth first)
+     *
+     */
+    bool Board::unhideEmptyNeighbours(size_t queueHead, size_t limit)
+    {
+        // m_revealed is both the queue and the result: tiles are appended once
+        // when opened, and each one is visited once -> linear time, no recursion
+        // (m_queue holds the same tiles as padded indices)
+        for (; queueHead < m_queue.size(); ++queueHead)
+        {
+            const uint32_t padded = m_queue[queueHead];
+            // only empty tiles (no mined neighbour) spread the opening
+            if (m_tiles[padded].m_mineCounter != 0)
+                continue;
+
+            const uint32_t tileIndex1D = m_revealed[queueHead];
+            uint32_t around[8];
+            m_layout.neighbours(padded, around);
+            for (uint32_t k = 0; k < 8; ++k)
+            {
+                const TileState state = m_tiles[around[k]].m_state;
+                // neighbours of an empty tile are never mines, sentinels are neither hidden nor peeked
+                if (state == TileState::hidden || state == TileState::peek)
+                    openTile(tileIndex1D + m_offsets[k], around[k]);
+            }
+            if (m_queue.size() > limit)
+                return false;
+        }
+        finishOpening();
+        return true;
+    }
+
+    /**
+     * @brief records the opened tiles as changes, player wins if every safe tile is open
+     *
+     */
+    void Board::finishOpening()
+    {
+        // let the front-end redraw the opened tiles
+        if (!m_headless)
+            m_changes.insert(m_changes.end(), m_revealed.begin(), m_revealed.end());
+
+        // every safe tile is open -> player wins without flagging
+        if (m_revealedSafe == size() - m_mines)
+            endGame(true);
+    }
+
+    /**
+     * @brief Ends the game and opens all hidden-mines
+     *
+     */
+    void Board::endGame(bool userWon)
+    {
+        m_status = userWon ? GameStatus::won : GameStatus::lost;
+        if (m_headless)
+            return;
+
+        // open all mines to let player know where were the mines
+        for (uint32_t row = 0; row < m_height; ++row)
+        {
+            for (uint32_t col = 0; col < m_width; ++col)
+            {
+                const uint32_t padded = m_layout.index(col + 1, row + 1);
+                if (m_tiles[padded].m_state != TileState::mineClicked && m_tiles[padded].m_isMine)
+                    setState(row * m_width + col, padded, TileState::notHidden);
+            }
+        }
+    }
+};
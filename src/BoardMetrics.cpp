@@ -0,0 +1,199 @@
+// BoardMetrics.cpp
+#include <BoardMetrics.h>
+#include <ThreadPool.h>
+#include <algorithm>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+namespace game
+{
+    namespace
+    {
+        // mine or border in MetricsScratch::numbers (never empty, never a number)
+        const uint8_t blocked = 9;
+
+        // root of a label, halving the path on the way
+        uint32_t findRoot(std::vector<uint32_t>& parents, uint32_t label)
+        {
+            while (parents[label] != label)
+            {
+                parents[label] = parents[parents[label]];
+                label = parents[label];
+            }
+            return label;
+        }
+
+        // merges two labels, the smaller root wins
+        uint32_t unite(std::vector<uint32_t>& parents, uint32_t a, uint32_t b)
+        {
+            a = findRoot(parents, a);
+            b = findRoot(parents, b);
+            if (a > b)
+                std::swap(a, b);
+            parents[b] = a;
+            return a;
+        }
+    }
+
+    /**
+     * @brief 3BV, openings and isolated numbers of a generated board
+     *
+     */
+    BoardMetrics computeMetrics(const Board& board, MetricsScratch& scratch)
+    {
+        const uint32_t width = board.width();
+        const uint32_t height = board.height();
+        const uint32_t stride = width + 2;
+        std::vector<uint8_t>& numbers = scratch.numbers;
+        std::vector<uint32_t>& labels = scratch.labels;
+        std::vector<uint32_t>& parents = scratch.parents;
+
+        // counters with a blocked border, so no neighbour check needs a bound check
+        numbers.assign(size_t(stride) * (height + 2), blocked);
+        for (uint32_t row = 0; row < height; ++row)
+        {
+            uint8_t* cells = &numbers[size_t(row + 1) * stride + 1];
+            board.forEachInRow(row, [cells](uint32_t col, const Tile& tile)
+            {
+                cells[col] = tile.m_isMine ? blocked : tile.m_mineCounter;
+            });
+        }
+
+        // first pass: label empty tiles from their already visited neighbours (left, up-left, up, up-right)
+        labels.assign(numbers.size(), 0);
+        parents.assign(1, 0);
+        for (uint32_t row = 1; row <= height; ++row)
+        {
+            for (uint32_t cell = row * stride + 1, end = cell + width; cell < end; ++cell)
+            {
+                if (numbers[cell] != 0)
+                    continue;
+                // the tile above touches the 3 others, they are already in its opening
+                uint32_t label = labels[cell - stride];
+                if (label == 0)
+                {
+                    const uint32_t upRight = labels[cell - stride + 1];
+                    const uint32_t upLeft = labels[cell - stride - 1];
+                    const uint32_t left = labels[cell - 1];
+                    // up-right doesn't touch left nor up-left: 2 openings may meet here
+                    if (upRight != 0)
+                        label = left != 0 || upLeft != 0 ? unite(parents, upRight, left != 0 ? left : upLeft) : upRight;
+                    else if (left != 0)
+                        label = left;
+                    else if (upLeft != 0)
+                        label = upLeft;
+                    else
+                    {
+                        label = uint32_t(parents.size());
+                        parents.push_back(label);
+                    }
+                }
+                labels[cell] = label;
+            }
+        }
+
+        BoardMetrics metrics;
+        // every label that is still a root is one opening
+        for (uint32_t label = 1; label < parents.size(); ++label)
+            metrics.openings += parents[label] == label;
+
+        // numbers with no empty neighbour are not opened by any opening
+        // "next to an empty tile" is a 3x3 OR, done as a row pass then a column pass (no branches)
+        std::vector<uint8_t>& nearEmpty = scratch.nearEmpty;
+        nearEmpty.assign(numbers.size(), 0);
+        for (uint32_t row = 1; row <= height; ++row)
+        {
+            for (uint32_t cell = row * stride + 1, end = cell + width; cell < end; ++cell)
+                nearEmpty[cell] = (numbers[cell - 1] == 0) | (numbers[cell] == 0) | (numbers[cell + 1] == 0);
+        }
+        for (uint32_t row = 1; row <= height; ++row)
+        {
+            for (uint32_t cell = row * stride + 1, end = cell + width; cell < end; ++cell)
+            {
+                const bool near = nearEmpty[cell - stride] | nearEmpty[cell] | nearEmpty[cell + stride];
+                metrics.isolatedNumbers += !near & (numbers[cell] != 0) & (numbers[cell] != blocked);
+            }
+        }
+        metrics.bbbv = metrics.openings + metrics.isolatedNumbers;
+        return metrics;
+    }
+
+    /**
+     * @brief generates the boards of a batch on all cores and measures them
+     *
+     */
+    void generateMetrics(const MetricsBatchConfig& config,
+                         const std::function<void(uint64_t, const std::vector<BoardMetrics>&)>& consume)
+    {
+        if (config.boards == 0)
+            return;
+        // the calling thread mostly waits for batches, so every core generates
+        const uint32_t threads = config.threads > 0 ? config.threads : std::max(1u, std::thread::hardware_concurrency());
+        const uint64_t batchSize = std::max(1u, config.batchSize);
+        const uint64_t batches = (config.boards + batchSize - 1) / batchSize;
+        // batches generated ahead of the consumer (slot of a batch: index % window)
+        const uint64_t window = std::min<uint64_t>(batches, uint64_t(threads) * 2 + 2);
+
+        struct Batch
+        {
+            std::vector<BoardMetrics> metrics;
+            bool done = false;
+        };
+        struct Worker
+        {
+            Board board;
+            MetricsScratch scratch;
+        };
+        std::vector<Batch> slots(window);
+        std::vector<std::unique_ptr<Worker>> workers;
+        for (uint32_t i = 0; i < threads; ++i)
+        {
+            workers.push_back(std::make_unique<Worker>());
+            workers.back()->board.setHeadless(true);
+        }
+        std::mutex mutex;
+        std::condition_variable finished;
+        // declared last: its destructor joins the workers before the state above goes away
+        ThreadPool pool(threads);
+
+        auto submit = [&](uint64_t batch)
+        {
+            pool.submit([&, batch]()
+            {
+                Worker& worker = *workers[pool.currentWorker()];
+                Batch& slot = slots[batch % window];
+                const uint64_t first = batch * batchSize;
+                slot.metrics.resize(size_t(std::min(batchSize, config.boards - first)));
+                for (size_t i = 0; i < slot.metrics.size(); ++i)
+                {
+                    worker.board.reset(config.width, config.height, config.mines);
+                    worker.board.generate(config.firstClick, config.seed + first + i, config.safeRadius);
+                    slot.metrics[i] = computeMetrics(worker.board, worker.scratch);
+                }
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    slot.done = true;
+                }
+                finished.notify_all();
+            });
+        };
+
+        uint64_t next = 0;
+        for (; next < window; ++next)
+            submit(next);
+        for (uint64_t batch = 0; batch < batches; ++batch)
+        {
+            Batch& slot = slots[batch % window];
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                finished.wait(lock, [&slot]() { return slot.done; });
+                slot.done = false;
+            }
+            consume(batch * batchSize, slot.metrics);
+            // the slot is free again: generate the batch that goes in it
+            if (next < batches)
+                submit(next++);
+        }
+    }
+};
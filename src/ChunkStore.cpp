@@ -0,0 +1,209 @@
+// ChunkStore.cpp
+#include <ChunkStore.h>
+#include <algorithm>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace game
+{
+    namespace
+    {
+        const char* const regionExtension = ".msr";
+
+        // floor(value / divisor) for negative values too
+        int64_t floorDiv(int64_t value, int64_t divisor)
+        {
+            return value >= 0 ? value / divisor : -1 - (-1 - value) / divisor;
+        }
+
+        void writeU32(char* bytes, uint32_t value)
+        {
+            for (uint32_t i = 0; i < 4; ++i)
+                bytes[i] = char(uint8_t(value >> (8 * i)));
+        }
+
+        uint32_t readU32(const char* bytes)
+        {
+            uint32_t value = 0;
+            for (uint32_t i = 0; i < 4; ++i)
+                value |= uint32_t(uint8_t(bytes[i])) << (8 * i);
+            return value;
+        }
+
+        // RegionHeader as it is on disk (same bytes on any host)
+        void encodeHeader(const RegionHeader& header, char (&bytes)[regionHeaderBytes])
+        {
+            std::copy(header.magic, header.magic + 4, bytes);
+            writeU32(bytes + 4, header.version);
+            writeU32(bytes + 8, header.chunkBytes);
+            writeU32(bytes + 12, header.reserved);
+        }
+
+        RegionHeader decodeHeader(const char (&bytes)[regionHeaderBytes])
+        {
+            RegionHeader header;
+            std::copy(bytes, bytes + 4, header.magic);
+            header.version = readU32(bytes + 4);
+            header.chunkBytes = readU32(bytes + 8);
+            header.reserved = readU32(bytes + 12);
+            return header;
+        }
+    }
+
+    // Default Constructor (You have to call open)
+    ChunkStore::ChunkStore()
+    {
+
+    }
+
+    ChunkStore::~ChunkStore()
+    {
+        close();
+    }
+
+    /**
+     * @brief creates the directory, removing region files left by an earlier game
+     *
+     */
+    bool ChunkStore::open(const std::filesystem::path& directory, uint32_t chunkBytes)
+    {
+        close();
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+        if (error)
+            return false;
+        m_directory = directory;
+        m_chunkBytes = chunkBytes;
+        m_written = 0;
+        m_read = 0;
+        removeRegionFiles();
+        return true;
+    }
+
+    // removes the region files (and the directory if nothing else is in it)
+    void ChunkStore::close()
+    {
+        if (m_fileOpen)
+            m_file.close();
+        m_fileOpen = false;
+        if (m_directory.empty())
+            return;
+        removeRegionFiles();
+        // fails (and keeps the directory) if it isn't empty
+        std::error_code error;
+        std::filesystem::remove(m_directory, error);
+        m_directory.clear();
+    }
+
+    /**
+     * @brief writes a chunk (over its earlier version)
+     *
+     */
+    bool ChunkStore::write(int64_t cx, int64_t cy, const uint8_t* bytes)
+    {
+        if (!openRegion(cx, cy, true))
+            return false;
+        // writing past the end leaves the slots in between as holes (read back as "not written")
+        const char written = 1;
+        m_file.seekp(slotOffset(cx, cy));
+        m_file.write(&written, 1);
+        m_file.write(reinterpret_cast<const char*>(bytes), m_chunkBytes);
+        if (!m_file)
+        {
+            m_file.clear();
+            return false;
+        }
+        m_written++;
+        return true;
+    }
+
+    /**
+     * @brief reads a chunk written earlier
+     *
+     */
+    bool ChunkStore::read(int64_t cx, int64_t cy, uint8_t* bytes)
+    {
+        if (!openRegion(cx, cy, false))
+            return false;
+        char written = 0;
+        m_file.seekg(slotOffset(cx, cy));
+        // past the end of the file -> never written
+        if (!m_file.read(&written, 1) || written != 1 ||
+            !m_file.read(reinterpret_cast<char*>(bytes), m_chunkBytes))
+        {
+            m_file.clear();
+            return false;
+        }
+        m_read++;
+        return true;
+    }
+
+    /**
+     * @brief makes m_file the region file of a chunk
+     *
+     */
+    bool ChunkStore::openRegion(int64_t cx, int64_t cy, bool create)
+    {
+        const int64_t rx = floorDiv(cx, regionSize);
+        const int64_t ry = floorDiv(cy, regionSize);
+        if (m_fileOpen && rx == m_fileRx && ry == m_fileRy)
+            return true;
+        if (m_directory.empty())
+            return false;
+        if (m_fileOpen)
+            m_file.close();
+        m_fileOpen = false;
+
+        const std::filesystem::path path = m_directory / ("r." + std::to_string(rx) + "." + std::to_string(ry) + regionExtension);
+        std::error_code error;
+        if (!std::filesystem::exists(path, error))
+        {
+            if (!create)
+                return false;
+            RegionHeader header;
+            header.chunkBytes = m_chunkBytes;
+            char bytes[regionHeaderBytes];
+            encodeHeader(header, bytes);
+            std::ofstream file(path, std::ios::binary);
+            if (!file.write(bytes, regionHeaderBytes))
+                return false;
+        }
+        m_file.open(path, std::ios::in | std::ios::out | std::ios::binary);
+        char bytes[regionHeaderBytes] = {};
+        const bool headerRead = bool(m_file.read(bytes, regionHeaderBytes));
+        const RegionHeader header = decodeHeader(bytes);
+        if (!headerRead || std::string(header.magic, 4) != "MSRG" || header.version != 1 || header.chunkBytes != m_chunkBytes)
+        {
+            m_file.close();
+            return false;
+        }
+        m_fileOpen = true;
+        m_fileRx = rx;
+        m_fileRy = ry;
+        return true;
+    }
+
+    // position of a chunk's slot in its region file
+    std::streamoff ChunkStore::slotOffset(int64_t cx, int64_t cy) const
+    {
+        const int64_t slot = (cy - floorDiv(cy, regionSize) * regionSize) * regionSize +
+                             (cx - floorDiv(cx, regionSize) * regionSize);
+        return std::streamoff(regionHeaderBytes + slot * (1 + int64_t(m_chunkBytes)));
+    }
+
+    // removes the region files in m_directory (the directory may hold anything else too)
+    void ChunkStore::removeRegionFiles()
+    {
+        // listed first, removing while iterating may skip entries
+        std::vector<std::filesystem::path> regions;
+        std::error_code error;
+        for (std::filesystem::directory_iterator it(m_directory, error), end; !error && it != end; it.increment(error))
+        {
+            if (it->path().extension() == regionExtension)
+                regions.push_back(it->path());
+        }
+        for (const std::filesystem::path& region : regions)
+            std::filesystem::remove(region, error);
+    }
+};
@@ -0,0 +1,136 @@
+// CoopClient.cpp
+#include <CoopClient.h>
+
+namespace game
+{
+    /**
+     * @brief connects and makes board a copy of the shared board
+     *
+     */
+    bool CoopClient::connect(const std::string& host, unsigned short port, Board& board, sf::Time timeout)
+    {
+        disconnect();
+        const std::optional<sf::IpAddress> address = sf::IpAddress::resolve(host);
+        if (!address)
+            return false;
+        m_socket.setBlocking(true);
+        if (m_socket.connect(*address, port, timeout) != sf::Socket::Status::Done)
+            return false;
+
+        // the welcome is the first packet, everything after it is an update
+        sf::Packet packet;
+        uint8_t message = 0;
+        if (m_socket.receive(packet) != sf::Socket::Status::Done || !(packet >> message) ||
+            CoopMessage(message) != CoopMessage::welcome || !apply(packet, board))
+        {
+            m_socket.disconnect();
+            return false;
+        }
+        m_socket.setBlocking(false);
+        m_connected = true;
+        return true;
+    }
+
+    void CoopClient::disconnect()
+    {
+        m_socket.disconnect();
+        m_connected = false;
+        m_outgoing.clear();
+    }
+
+    /**
+     * @brief queues an action for the server
+     *
+     */
+    void CoopClient::send(ActionType type, uint32_t tileIndex1D)
+    {
+        if (!m_connected)
+            return;
+        sf::Packet packet;
+        packet << uint8_t(CoopMessage::action) << uint8_t(type) << tileIndex1D;
+        m_outgoing.push_back(std::move(packet));
+    }
+
+    /**
+     * @brief sends queued actions and applies the updates received so far to board
+     *
+     */
+    bool CoopClient::poll(Board& board)
+    {
+        if (!m_connected)
+            return false;
+
+        // a partly sent packet is sent again until done (the socket remembers how much went out)
+        while (!m_outgoing.empty())
+        {
+            const sf::Socket::Status status = m_socket.send(m_outgoing.front());
+            if (status == sf::Socket::Status::Done)
+                m_outgoing.pop_front();
+            else if (status == sf::Socket::Status::Partial || status == sf::Socket::Status::NotReady)
+                break;
+            else
+            {
+                disconnect();
+                return false;
+            }
+        }
+
+        sf::Packet packet;
+        while (true)
+        {
+            const sf::Socket::Status status = m_socket.receive(packet);
+            if (status == sf::Socket::Status::NotReady || status == sf::Socket::Status::Partial)
+                return true;
+            uint8_t message = 0;
+            if (status != sf::Socket::Status::Done || !(packet >> message) ||
+                CoopMessage(message) != CoopMessage::update || !apply(packet, board))
+            {
+                disconnect();
+                return false;
+            }
+        }
+    }
+
+    /**
+     * @brief applies a welcome or update to board
+     *
+     */
+    bool CoopClient::apply(sf::Packet& packet, Board& board)
+    {
+        const bool welcome = !m_connected;
+        if (welcome)
+        {
+            uint32_t width = 0;
+            uint32_t height = 0;
+            uint32_t mines = 0;
+            if (!(packet >> width >> height >> mines >> m_seed >> m_safeRadius) || !board.reset(width, height, mines))
+                return false;
+            m_versions.assign(board.size(), 0);
+            m_generated = false;
+            m_changesReceived = 0;
+        }
+
+        uint8_t status = 0;
+        uint32_t firstClick = SharedBoard::noTile;
+        if (!(packet >> status >> firstClick) || !readChanges(packet, m_changes))
+            return false;
+        // same seed and first click -> same level as the server's
+        if (!m_generated && firstClick < board.size())
+        {
+            board.generate(firstClick, m_seed, m_safeRadius);
+            m_generated = true;
+        }
+        for (const TileChange& change : m_changes)
+        {
+            // an older change of a tile may arrive after a newer one (welcome vs. updates already queued)
+            if (change.tileIndex1D >= board.size() || change.version <= m_versions[change.tileIndex1D])
+                continue;
+            m_versions[change.tileIndex1D] = change.version;
+            board.setTileState(change.tileIndex1D, change.state);
+        }
+        m_changesReceived += m_changes.size();
+        if (GameStatus(status) == GameStatus::won || GameStatus(status) == GameStatus::lost)
+            board.finish(GameStatus(status) == GameStatus::won);
+        return true;
+    }
+};
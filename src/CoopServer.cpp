@@ -0,0 +1,240 @@
+// CoopServer.cpp
+#include <CoopServer.h>
+#include <algorithm>
+
+namespace game
+{
+    CoopServer::CoopServer(SharedBoard& board, uint32_t threads)
+        : m_board(board), m_pool(threads)
+    {
+        m_workerChanges.resize(m_pool.size());
+    }
+
+    // disconnects every client
+    CoopServer::~CoopServer()
+    {
+        stop();
+    }
+
+    /**
+     * @brief listens on a port and starts the network thread
+     *
+     */
+    bool CoopServer::start(unsigned short port)
+    {
+        stop();
+        if (m_listener.listen(port) != sf::Socket::Status::Done)
+            return false;
+        m_listener.setBlocking(false);
+        m_selector.add(m_listener);
+        m_stop = false;
+        m_thread = std::thread(&CoopServer::run, this);
+        return true;
+    }
+
+    // stops the network thread and disconnects every client
+    void CoopServer::stop()
+    {
+        m_stop = true;
+        if (m_thread.joinable())
+            m_thread.join();
+        m_selector.clear();
+        m_clients.clear();
+        m_clientCount = 0;
+        m_listener.close();
+    }
+
+    // network thread loop
+    void CoopServer::run()
+    {
+        while (!m_stop)
+        {
+            if (m_selector.wait(sf::milliseconds(pollIntervalMs)))
+            {
+                if (m_selector.isReady(m_listener))
+                    accept();
+                for (size_t i = 0; i < m_clients.size(); ++i)
+                {
+                    if (m_selector.isReady(m_clients[i]->socket) && !receive(*m_clients[i]))
+                        m_clients[i].reset();
+                }
+                dropClosedClients();
+            }
+
+            broadcast();
+            for (std::unique_ptr<Client>& client : m_clients)
+            {
+                if (!flush(*client))
+                    client.reset();
+            }
+            dropClosedClients();
+        }
+    }
+
+    // removes the clients that left (their queued updates are dropped)
+    void CoopServer::dropClosedClients()
+    {
+        m_clients.erase(std::remove(m_clients.begin(), m_clients.end(), nullptr), m_clients.end());
+        m_clientCount = uint32_t(m_clients.size());
+    }
+
+    // sends the welcome to a new client
+    void CoopServer::accept()
+    {
+        while (true)
+        {
+            auto client = std::make_unique<Client>();
+            if (m_listener.accept(client->socket) != sf::Socket::Status::Done)
+                return;
+            client->socket.setBlocking(false);
+
+            // updates queued after the welcome may repeat a change of the snapshot, clients keep the newest version
+            std::vector<TileChange> tiles;
+            m_board.snapshot(tiles);
+            sf::Packet packet;
+            packet << uint8_t(CoopMessage::welcome) << m_board.width() << m_board.height() << m_board.mines()
+                   << uint64_t(m_board.seed()) << m_board.safeRadius() << uint8_t(m_board.status())
+                   << m_board.firstClick();
+            writeChanges(packet, tiles);
+            client->outgoing.push_back(std::move(packet));
+
+            m_selector.add(client->socket);
+            m_clients.push_back(std::move(client));
+        }
+    }
+
+    /**
+     * @brief reads the actions a client sent and queues them to run on the pool
+     *
+     */
+    bool CoopServer::receive(Client& client)
+    {
+        sf::Packet packet;
+        while (true)
+        {
+            const sf::Socket::Status status = client.socket.receive(packet);
+            if (status == sf::Socket::Status::NotReady || status == sf::Socket::Status::Partial)
+                return true;
+            uint8_t message = 0;
+            uint8_t type = 0;
+            uint32_t tileIndex1D = 0;
+            if (status != sf::Socket::Status::Done || !(packet >> message >> type >> tileIndex1D) ||
+                CoopMessage(message) != CoopMessage::action || type > uint8_t(ActionType::chord))
+            {
+                m_selector.remove(client.socket);
+                return false;
+            }
+            // a client's actions run in order: a flag then a chord must not run as a chord then a flag
+            std::shared_ptr<ActionQueue>& queue = client.actions;
+            std::lock_guard<std::mutex> lock(queue->mutex);
+            if (queue->actions.size() >= maxQueuedActions)
+            {
+                m_selector.remove(client.socket);
+                return false;
+            }
+            queue->actions.push_back({ActionType(type), tileIndex1D});
+            if (!queue->running)
+            {
+                queue->running = true;
+                m_pool.submit([this, queue]() { runQueued(queue); });
+            }
+        }
+    }
+
+    /**
+     * @brief runs the oldest action of a client, then defers itself while actions are queued
+     *
+     */
+    void CoopServer::runQueued(const std::shared_ptr<ActionQueue>& queue)
+    {
+        QueuedAction action;
+        {
+            std::lock_guard<std::mutex> lock(queue->mutex);
+            action = queue->actions.front();
+            queue->actions.pop_front();
+        }
+        apply(action.type, action.tileIndex1D);
+
+        // behind the other clients' tasks on this worker: a busy client doesn't hold it
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        if (queue->actions.empty())
+            queue->running = false;
+        else
+            m_pool.defer([this, queue]() { runQueued(queue); });
+    }
+
+    /**
+     * @brief runs an action on a pool worker
+     *
+     */
+    void CoopServer::apply(ActionType type, uint32_t tileIndex1D)
+    {
+        std::vector<TileChange>& changes = m_workerChanges[m_pool.currentWorker()];
+        changes.clear();
+        if (type == ActionType::reveal)
+            m_board.reveal(tileIndex1D, changes);
+        else if (type == ActionType::flag)
+            m_board.toggleFlag(tileIndex1D, changes);
+        else
+            m_board.chord(tileIndex1D, changes);
+        m_actions.fetch_add(1, std::memory_order_relaxed);
+        if (changes.empty())
+            return;
+        std::lock_guard<std::mutex> lock(m_outboxMutex);
+        m_outbox.insert(m_outbox.end(), changes.begin(), changes.end());
+    }
+
+    // one update of the changes since the last one, queued for every client
+    void CoopServer::broadcast()
+    {
+        m_sending.clear();
+        {
+            std::lock_guard<std::mutex> lock(m_outboxMutex);
+            std::swap(m_sending, m_outbox);
+        }
+        // read after the changes: an update never carries a status older than its changes
+        const GameStatus status = m_board.status();
+        if (m_sending.empty() && status == m_sentStatus)
+            return;
+        m_sentStatus = status;
+
+        sf::Packet packet;
+        packet << uint8_t(CoopMessage::update) << uint8_t(status) << m_board.firstClick();
+        writeChanges(packet, m_sending);
+        for (std::unique_ptr<Client>& client : m_clients)
+        {
+            if (client->outgoing.size() >= maxQueuedUpdates)
+            {
+                m_selector.remove(client->socket);
+                client.reset();
+                continue;
+            }
+            client->outgoing.push_back(packet);
+        }
+        dropClosedClients();
+        m_updatesSent.fetch_add(m_clients.size(), std::memory_order_relaxed);
+        m_changesSent.fetch_add(m_sending.size() * m_clients.size(), std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief sends what the socket takes from a client's queue
+     *
+     */
+    bool CoopServer::flush(Client& client)
+    {
+        // a partly sent packet is sent again until done (the socket remembers how much went out)
+        while (!client.outgoing.empty())
+        {
+            const sf::Socket::Status status = client.socket.send(client.outgoing.front());
+            if (status == sf::Socket::Status::Partial || status == sf::Socket::Status::NotReady)
+                return true;
+            if (status != sf::Socket::Status::Done)
+            {
+                m_selector.remove(client.socket);
+                return false;
+            }
+            client.outgoing.pop_front();
+        }
+        return true;
+    }
+};
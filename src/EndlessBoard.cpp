@@ -0,0 +1,394 @@
+// EndlessBoard.cpp
+#include <EndlessBoard.h>
+#include <Random.h>
+#include <algorithm>
+
+namespace game
+{
+    namespace
+    {
+        // chunk of a tile column/row (floor division, negative tiles too)
+        int64_t chunkCoord(int64_t tile)
+        {
+            const int64_t size = EndlessBoard::chunkSize;
+            return tile >= 0 ? tile / size : -1 - (-1 - tile) / size;
+        }
+
+        // 2-bit tile state on disk (peeked tiles are saved as hidden)
+        uint8_t stateCode(TileState state)
+        {
+            switch (state)
+            {
+            case TileState::notHidden: return 1;
+            case TileState::flagged: return 2;
+            case TileState::mineClicked: return 3;
+            default: return 0;
+            }
+        }
+
+        TileState codeState(uint8_t code)
+        {
+            static const TileState states[4] = {TileState::hidden, TileState::notHidden,
+                                                 TileState::flagged, TileState::mineClicked};
+            return states[code & 3];
+        }
+    }
+
+    // Default Constructor (You have to call reset)
+    EndlessBoard::EndlessBoard()
+    {
+
+    }
+
+    /**
+     * @brief starts a new endless board
+     *
+     */
+    bool EndlessBoard::reset(uint64_t seed, float mineDensity, const std::filesystem::path& storeDirectory,
+                             size_t maxChunks)
+    {
+        m_chunks.clear();
+        m_chunkIndex.clear();
+        m_lastChunk = nullptr;
+        // a chunk and the (up to 3) chunks around a tile near its corner always fit
+        m_maxChunks = std::max<size_t>(maxChunks, 16);
+        m_changes.clear();
+        m_queue.clear();
+        m_seed = seed;
+        mineDensity = std::clamp(mineDensity, minMineDensity, maxMineDensity);
+        m_mineThreshold = uint64_t(double(mineDensity) * 18446744073709551615.0);
+        m_status = GameStatus::playing;
+        m_revealedSafe = 0;
+        m_flags = 0;
+        m_chunksMade = 0;
+        m_chunksEvicted = 0;
+        m_packed.assign(chunkStateBytes, 0);
+        m_halo.assign(size_t(chunkSize + 2) * (chunkSize + 2), 0);
+        return m_store.open(storeDirectory, chunkStateBytes);
+    }
+
+    /**
+     * @brief opens a tile, opening its empty neighbours too (player loses on a mine)
+     *
+     */
+    bool EndlessBoard::reveal(const EndlessPos& pos)
+    {
+        m_queue.clear();
+        if (m_status != GameStatus::playing)
+            return false;
+
+        Chunk& chunk = chunkOf(pos);
+        const Tile& tile = chunk.tiles[localIndex(pos)];
+        // ignore clicking on already-openned or flagged tiles
+        if (tile.m_state == TileState::notHidden || tile.m_state == TileState::flagged)
+            return false;
+
+        // player opens a mine -> Loses
+        if (tile.m_isMine)
+        {
+            setState(chunk, pos, TileState::mineClicked);
+            endGame();
+            return true;
+        }
+
+        // player opens a non-mined tile (and all empty tiles connected to it, in any chunk)
+        openTile(pos);
+        unhideEmptyNeighbours();
+        return true;
+    }
+
+    /**
+     * @brief sets/unsets a flag on a hidden tile
+     *
+     */
+    bool EndlessBoard::toggleFlag(const EndlessPos& pos)
+    {
+        if (m_status != GameStatus::playing)
+            return false;
+
+        Chunk& chunk = chunkOf(pos);
+        const TileState state = chunk.tiles[localIndex(pos)].m_state;
+        // unsetting a flag
+        if (state == TileState::flagged)
+        {
+            setState(chunk, pos, TileState::hidden);
+            m_flags--;
+            return true;
+        }
+        // ignore right-clicking on openned tile
+        if (state != TileState::hidden && state != TileState::peek)
+            return false;
+
+        // setting a flag (no flag limit, the board has no mine count)
+        setState(chunk, pos, TileState::flagged);
+        m_flags++;
+        return true;
+    }
+
+    /**
+     * @brief opens all non-flagged neighbours if number of flagged neighbours >= number of tile
+     *
+     */
+    bool EndlessBoard::chord(const EndlessPos& pos)
+    {
+        m_queue.clear();
+        if (m_status != GameStatus::playing)
+            return false;
+        const Tile center = tile(pos);
+        if (center.m_state != TileState::notHidden)
+            return false;
+
+        // check neighbours with flags (they may be in other chunks)
+        uint32_t flagCounter = 0;
+        bool flagNotOnMine = false;
+        for (const NeighbourStep& step : neighbourSteps)
+        {
+            const Tile& neighbour = tile({pos.x + step.dx, pos.y + step.dy});
+            if (neighbour.m_state == TileState::flagged)
+            {
+                flagCounter++;
+                if (!neighbour.m_isMine)
+                    flagNotOnMine = true;
+            }
+        }
+
+        // not enough flags, player is just peeking
+        if (flagCounter < uint32_t(center.m_mineCounter))
+            return false;
+
+        // a flag was on wrong tile -> player loses
+        if (flagNotOnMine)
+        {
+            endGame();
+            return true;
+        }
+
+        for (const NeighbourStep& step : neighbourSteps)
+            openTile({pos.x + step.dx, pos.y + step.dy});
+        unhideEmptyNeighbours();
+        return true;
+    }
+
+    /**
+     * @brief marks hidden neighbours of a tile as peeked or back to hidden
+     *
+     */
+    void EndlessBoard::peek(const EndlessPos& pos, bool peeking)
+    {
+        const TileState from = peeking ? TileState::hidden : TileState::peek;
+        const TileState to = peeking ? TileState::peek : TileState::hidden;
+        for (const NeighbourStep& step : neighbourSteps)
+        {
+            const EndlessPos neighbour {pos.x + step.dx, pos.y + step.dy};
+            Chunk& chunk = chunkOf(neighbour);
+            if (chunk.tiles[localIndex(neighbour)].m_state == from)
+                setState(chunk, neighbour, to);
+        }
+    }
+
+    /**
+     * @brief a tile (its chunk is made or loaded if it isn't in memory)
+     *
+     */
+    const Tile& EndlessBoard::tile(const EndlessPos& pos)
+    {
+        return chunkOf(pos).tiles[localIndex(pos)];
+    }
+
+    size_t EndlessBoard::ChunkKeyHash::operator()(const ChunkKey& key) const
+    {
+        uint64_t state = uint64_t(key.cx) * 0x9e3779b97f4a7c15ull ^ uint64_t(key.cy);
+        return size_t(Random::splitmix64(state));
+    }
+
+    /**
+     * @brief the chunk of a tile, made or loaded (and something else evicted) if needed
+     *
+     */
+    EndlessBoard::Chunk& EndlessBoard::chunkOf(const EndlessPos& pos)
+    {
+        const ChunkKey key {chunkCoord(pos.x), chunkCoord(pos.y)};
+        if (m_lastChunk != nullptr && m_lastChunk->cx == key.cx && m_lastChunk->cy == key.cy)
+            return *m_lastChunk;
+
+        const auto found = m_chunkIndex.find(key);
+        if (found != m_chunkIndex.end())
+        {
+            // most recently used first (list nodes don't move, only their links)
+            m_chunks.splice(m_chunks.begin(), m_chunks, found->second);
+            m_lastChunk = &*found->second;
+            return *m_lastChunk;
+        }
+
+        while (m_chunks.size() >= m_maxChunks && evictChunk())
+            ;
+        m_chunks.emplace_front();
+        Chunk& chunk = m_chunks.front();
+        chunk.cx = key.cx;
+        chunk.cy = key.cy;
+        makeChunk(chunk);
+        m_chunkIndex.emplace(key, m_chunks.begin());
+        m_lastChunk = &chunk;
+        return chunk;
+    }
+
+    /**
+     * @brief sets the mines and counters of a new chunk, then the states saved in the store
+     *
+     */
+    void EndlessBoard::makeChunk(Chunk& chunk)
+    {
+        // mines of the chunk and of a 1-tile border around it (from the hashes of the chunks
+        // next to it, those chunks aren't made) -> counters are right on the chunk's border too
+        const int64_t haloSize = chunkSize + 2;
+        const int64_t left = chunk.cx * chunkSize - 1;
+        const int64_t top = chunk.cy * chunkSize - 1;
+        for (int64_t row = 0; row < haloSize; ++row)
+        {
+            for (int64_t col = 0; col < haloSize; ++col)
+                m_halo[size_t(row * haloSize + col)] = isMine(left + col, top + row);
+        }
+
+        for (int64_t y = 0; y < chunkSize; ++y)
+        {
+            for (int64_t x = 0; x < chunkSize; ++x)
+            {
+                const uint8_t* above = &m_halo[size_t(y * haloSize + x)];
+                const uint8_t* middle = above + haloSize;
+                const uint8_t* below = middle + haloSize;
+                Tile& tile = chunk.tiles[size_t(y * chunkSize + x)];
+                tile = Tile();
+                tile.m_isMine = middle[1] != 0;
+                tile.m_mineCounter = short(above[0] + above[1] + above[2] + middle[0] + middle[2] +
+                                           below[0] + below[1] + below[2]);
+            }
+        }
+
+        // states the player left in the chunk before it was evicted
+        if (m_store.read(chunk.cx, chunk.cy, m_packed.data()))
+        {
+            for (uint32_t i = 0; i < chunkTiles; ++i)
+                chunk.tiles[i].m_state = codeState(uint8_t(m_packed[i / 4] >> (i % 4 * 2)));
+        }
+        chunk.dirty = false;
+        m_chunksMade++;
+    }
+
+    /**
+     * @brief saves the least recently used chunk's states if it is dirty and drops it
+     *
+     */
+    bool EndlessBoard::evictChunk()
+    {
+        if (m_chunks.empty())
+            return false;
+        const auto last = std::prev(m_chunks.end());
+        Chunk& chunk = *last;
+        // chunks the player never changed are made again from the hash
+        if (chunk.dirty)
+        {
+            std::fill(m_packed.begin(), m_packed.end(), uint8_t(0));
+            for (uint32_t i = 0; i < chunkTiles; ++i)
+                m_packed[i / 4] |= uint8_t(stateCode(chunk.tiles[i].m_state) << (i % 4 * 2));
+            if (!m_store.write(chunk.cx, chunk.cy, m_packed.data()))
+            {
+                // memory grows rather than the player's tiles being lost
+                m_chunks.splice(m_chunks.begin(), m_chunks, last);
+                return false;
+            }
+        }
+        if (m_lastChunk == &chunk)
+            m_lastChunk = nullptr;
+        m_chunkIndex.erase({chunk.cx, chunk.cy});
+        m_chunks.erase(last);
+        m_chunksEvicted++;
+        return true;
+    }
+
+    /**
+     * @brief whether a tile is a mine
+     *
+     */
+    bool EndlessBoard::isMine(int64_t x, int64_t y) const
+    {
+        // the game starts by opening the start tile -> it always opens an empty area
+        if (x >= -1 && x <= 1 && y >= -1 && y <= 1)
+            return false;
+        uint64_t chunkState = m_seed ^ uint64_t(chunkCoord(x)) * 0x9e3779b97f4a7c15ull ^
+                              uint64_t(chunkCoord(y)) * 0xc2b2ae3d27d4eb4full;
+        uint64_t tileState = Random::splitmix64(chunkState) + localIndex({x, y});
+        return Random::splitmix64(tileState) < m_mineThreshold;
+    }
+
+    /**
+     * @brief update one tile's state
+     *
+     */
+    void EndlessBoard::setState(Chunk& chunk, const EndlessPos& pos, TileState state)
+    {
+        chunk.tiles[localIndex(pos)].m_state = state;
+        chunk.dirty = true;
+        m_changes.push_back(pos);
+    }
+
+    /**
+     * @brief opens one hidden non-mined tile and queues it for unhideEmptyNeighbours
+     *
+     */
+    void EndlessBoard::openTile(const EndlessPos& pos)
+    {
+        Chunk& chunk = chunkOf(pos);
+        const Tile& tile = chunk.tiles[localIndex(pos)];
+        if ((tile.m_state != TileState::hidden && tile.m_state != TileState::peek) || tile.m_isMine)
+            return;
+        setState(chunk, pos, TileState::notHidden);
+        m_revealedSafe++;
+        m_queue.push_back(pos);
+    }
+
+    /**
+     * @brief opens/unhides non-mined neighbours of every empty tile queued in m_queue
+     *
+     */
+    void EndlessBoard::unhideEmptyNeighbours()
+    {
+        // every tile opened is appended once (breadth first); empty areas end, the density is >= minMineDensity
+        for (size_t queueHead = 0; queueHead < m_queue.size(); ++queueHead)
+        {
+            const EndlessPos pos = m_queue[queueHead];
+            if (tile(pos).m_mineCounter != 0)
+                continue;
+            // neighbours of an empty tile are never mines
+            for (const NeighbourStep& step : neighbourSteps)
+                openTile({pos.x + step.dx, pos.y + step.dy});
+        }
+    }
+
+    /**
+     * @brief Ends the game and opens the mines of the chunks in memory
+     *
+     */
+    void EndlessBoard::endGame()
+    {
+        m_status = GameStatus::lost;
+        // the rest of the board is endless, the player sees the mines around where they played
+        for (Chunk& chunk : m_chunks)
+        {
+            for (uint32_t i = 0; i < chunkTiles; ++i)
+            {
+                const Tile& tile = chunk.tiles[i];
+                if (tile.m_state != TileState::mineClicked && tile.m_isMine)
+                    setState(chunk, {chunk.cx * chunkSize + i % chunkSize, chunk.cy * chunkSize + i / chunkSize},
+                             TileState::notHidden);
+            }
+        }
+    }
+
+    // place of a tile in its chunk
+    uint32_t EndlessBoard::localIndex(const EndlessPos& pos)
+    {
+        const int64_t x = pos.x - chunkCoord(pos.x) * chunkSize;
+        const int64_t y = pos.y - chunkCoord(pos.y) * chunkSize;
+        return uint32_t(y * chunkSize + x);
+    }
+};
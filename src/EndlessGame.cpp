@@ -0,0 +1,308 @@
+// EndlessGame.cpp
+#include <EndlessGame.h>
+
+namespace game
+{
+    namespace
+    {
+        // floor(value / divisor) for negative values too
+        int64_t floorDiv(int64_t value, int64_t divisor)
+        {
+            return value >= 0 ? value / divisor : -1 - (-1 - value) / divisor;
+        }
+
+        // window size in tiles when it fits the screen
+        const uint32_t windowColumns = 40u;
+        const uint32_t windowRows = 25u;
+    }
+
+    // Default Constructor (You have to call init to initialize game)
+    EndlessGame::EndlessGame()
+    {
+
+    }
+
+    // Init The Game (should be called before run), the start tile is opened
+    bool EndlessGame::init(const std::filesystem::path& _tilesetPath, uint16_t tileSize, float mineDensity, uint64_t seed)
+    {
+        // evicted chunks go to scratch files of this game, removed when it ends or the next one starts
+        // (random name: two games with the same seed, in this process or another, must not share them)
+        std::error_code error;
+        std::random_device randomDevice;
+        const uint64_t storeId = (uint64_t(randomDevice()) << 32) | randomDevice();
+        const std::filesystem::path storeDirectory = std::filesystem::temp_directory_path(error) /
+                                                     ("minesweeper-endless-" + std::to_string(seed) + "-" + std::to_string(storeId));
+        if (error || !board.reset(seed, mineDensity, storeDirectory))
+        {
+            std::cout << "couldn't create chunk store " << storeDirectory.string() << "\n";
+            return false;
+        }
+        this->tileSize = tileSize;
+        gameFinished = false;
+        panning = false;
+        wasPeeking = false;
+
+        // Setup Window
+        const sf::Vector2u desktopSize = sf::VideoMode::getDesktopMode().size;
+        const sf::Vector2u windowSize(std::max(1u, std::min(windowColumns * tileSize, unsigned(desktopSize.x * 0.9f))),
+                                      std::max(1u, std::min(windowRows * tileSize, unsigned(desktopSize.y * 0.9f))));
+        window.create(sf::VideoMode(windowSize), "Minesweeper (endless)");
+        window.setFramerateLimit(60);
+        AssetCache& assets = AssetCache::instance();
+        if (const sf::Image* icon = assets.image(iconPath))
+            window.setIcon(*icon);
+
+        // Setup UI (score && flags)
+        const sf::Font* font = assets.font(fontPath);
+        tileset = assets.texture(_tilesetPath);
+        if (!font || !tileset)
+            return false;
+        const unsigned int textSize = window.getSize().x / 20;
+        scoreText.setFont(*font);
+        scoreText.setCharacterSize(textSize);
+        scoreText.setPosition({10.f, 5.f});
+        scoreText.setFillColor(sf::Color::Black);
+        flagsText.setFont(*font);
+        flagsText.setCharacterSize(textSize);
+        flagsText.setPosition({10.f, 35.f});
+        flagsText.setFillColor(sf::Color::Red);
+
+        // start tile in the middle of the window, already opened
+        camera = {int64_t(tileSize / 2) - int64_t(windowSize.x / 2), int64_t(tileSize / 2) - int64_t(windowSize.y / 2)};
+        board.reveal({0, 0});
+        board.clearChanges();
+        reloadTiles();
+        updateHud();
+        std::cout << "seed: " << seed << "\n";
+        return true;
+    }
+
+    /**
+     * @brief Game/Main Loop
+     *
+     * @return true if game finishes before player closing window
+     * @return false if player closes window
+     */
+    bool EndlessGame::run()
+    {
+        scheduler.reset();
+        while (window.isOpen())
+        {
+            // nothing to draw -> sleep until an event arrives or the end-game close
+            if (!scheduler.isDirty())
+            {
+                const sf::Time wakeUp = gameFinished ?
+                    sf::milliseconds(std::max(1, endGameDelayMs - clock.getElapsedTime().asMilliseconds())) : sf::Time::Zero;
+                const std::optional event = window.waitEvent(wakeUp);
+                scheduler.wokeUp();
+                if (event)
+                    handleEvent(event);
+            }
+            while (const std::optional event = window.pollEvent())
+                handleEvent(event);
+
+            // close game after delay 3.5s from game finish
+            if (gameFinished && clock.getElapsedTime().asMilliseconds() >= endGameDelayMs)
+            {
+                window.close();
+                printStats();
+                return true;
+            }
+
+            if (!scheduler.isDirty() || !window.isOpen())
+                continue;
+            window.clear();
+            window.setView(view);
+            window.draw(tilemap);
+            window.draw(scoreText);
+            window.draw(flagsText);
+            window.display();
+            scheduler.frameRendered();
+        }
+        // if user closed window before game finish
+        printStats();
+        return false;
+    }
+
+    void EndlessGame::handleEvent(const std::optional<sf::Event>& event)
+    {
+        if (event->is<sf::Event::Closed>())
+            window.close();
+
+        // the tilemap covers the window, a bigger window needs more tiles
+        else if (event->is<sf::Event::Resized>())
+            reloadTiles();
+
+        // window contents may have been lost while it was hidden
+        else if (event->is<sf::Event::FocusGained>() || event->is<sf::Event::MouseEntered>())
+            scheduler.markDirty();
+
+        else if (const auto* key = event->getIf<sf::Event::KeyPressed>())
+        {
+            // arrows/WASD pan by a quarter of the window, Home goes back to the start tile
+            const int64_t stepX = window.getSize().x / 4;
+            const int64_t stepY = window.getSize().y / 4;
+            if (key->code == sf::Keyboard::Key::Left || key->code == sf::Keyboard::Key::A)
+                panView({-stepX, 0});
+            else if (key->code == sf::Keyboard::Key::Right || key->code == sf::Keyboard::Key::D)
+                panView({stepX, 0});
+            else if (key->code == sf::Keyboard::Key::Up || key->code == sf::Keyboard::Key::W)
+                panView({0, -stepY});
+            else if (key->code == sf::Keyboard::Key::Down || key->code == sf::Keyboard::Key::S)
+                panView({0, stepY});
+            else if (key->code == sf::Keyboard::Key::Home)
+                panView({int64_t(tileSize / 2) - int64_t(window.getSize().x / 2) - camera.x,
+                         int64_t(tileSize / 2) - int64_t(window.getSize().y / 2) - camera.y});
+        }
+
+        else if (const auto* moved = event->getIf<sf::Event::MouseMoved>())
+        {
+            // drag the board while middle button is held
+            if (panning)
+            {
+                const sf::Vector2i offset = panLastPos - moved->position;
+                panView({offset.x, offset.y});
+                panLastPos = moved->position;
+            }
+        }
+
+        else if (const auto* mouse = event->getIf<sf::Event::MouseButtonReleased>())
+        {
+            if (mouse->button == sf::Mouse::Button::Middle)
+                panning = false;
+            if (wasPeeking)
+            {
+                board.peek(tilePeeked, false);
+                wasPeeking = false;
+            }
+        }
+
+        else if (const auto* mouse = event->getIf<sf::Event::MouseButtonPressed>())
+        {
+            // middle button drags the board
+            if (mouse->button == sf::Mouse::Button::Middle)
+            {
+                panning = true;
+                panLastPos = mouse->position;
+                return;
+            }
+
+            // which button is pressed
+            const bool left = sf::Mouse::isButtonPressed(sf::Mouse::Button::Left);
+            const bool right = sf::Mouse::isButtonPressed(sf::Mouse::Button::Right);
+            const EndlessPos pos = tileFromScreenPos(mouse->position);
+
+            // Both Buttons Clicked (Peeking Neighbours)
+            if (left && right)
+            {
+                // to peek neighbours of a tile, the tile must be not-hidden
+                if (board.tile(pos).m_state != TileState::notHidden)
+                    return;
+                board.peek(pos, true);
+                // not enough flags -> player is just peeking until the buttons are released
+                if (!board.chord(pos))
+                {
+                    wasPeeking = true;
+                    tilePeeked = pos;
+                }
+            }
+            else if (left)
+                board.reveal(pos);
+            else if (right)
+                board.toggleFlag(pos);
+        }
+        syncBoard();
+    }
+
+    /**
+     * @brief moves the view
+     *
+     * @param offset offset in board pixels
+     */
+    void EndlessGame::panView(sf::Vector2<int64_t> offset)
+    {
+        camera += offset;
+        // tiles are rewritten only when the view moved by whole tiles
+        if (floorDiv(camera.x, tileSize) != origin.x || floorDiv(camera.y, tileSize) != origin.y)
+            reloadTiles();
+        else
+            tilemap.setPosition({float(origin.x * tileSize - camera.x), float(origin.y * tileSize - camera.y)});
+        scheduler.markDirty();
+    }
+
+    /**
+     * @brief sizes the tilemap to the window and rewrites all its tiles
+     *
+     */
+    void EndlessGame::reloadTiles()
+    {
+        // one more tile on each side than the window shows: the map is moved by up to a tile
+        const sf::Vector2u windowSize = window.getSize();
+        columns = windowSize.x / tileSize + 2;
+        rows = windowSize.y / tileSize + 2;
+        origin = {floorDiv(camera.x, tileSize), floorDiv(camera.y, tileSize)};
+
+        // chunks reached by the view are made here
+        tilemap.load(*tileset, {tileSize, tileSize}, columns, rows, [this](uint32_t tileIndex1D)
+        {
+            return board.tile({origin.x + tileIndex1D % columns, origin.y + tileIndex1D / columns}).getMapIndex();
+        });
+        tilemap.setPosition({float(origin.x * tileSize - camera.x), float(origin.y * tileSize - camera.y)});
+        view = sf::View(sf::FloatRect({0.f, 0.f}, sf::Vector2f(windowSize)));
+        scheduler.markDirty();
+    }
+
+    /**
+     * @brief redraws tiles changed by the last board action and ends the game if player lost
+     *
+     */
+    void EndlessGame::syncBoard()
+    {
+        if (board.changes().empty())
+            return;
+        // tiles out of the view are drawn from the board when the view reaches them
+        for (const EndlessPos& pos : board.changes())
+        {
+            const int64_t col = pos.x - origin.x;
+            const int64_t row = pos.y - origin.y;
+            if (col >= 0 && row >= 0 && col < int64_t(columns) && row < int64_t(rows))
+                tilemap.updateTile(uint32_t(row * columns + col), board.tile(pos).getMapIndex());
+        }
+        board.clearChanges();
+        updateHud();
+        scheduler.markDirty();
+
+        if (!gameFinished && board.isFinished())
+        {
+            gameFinished = true;
+            clock.restart();
+            std::cout << "lose, score: " << board.revealedSafe() << "\n";
+        }
+    }
+
+    // rewrites the score and flags texts
+    void EndlessGame::updateHud()
+    {
+        scoreText.setString("score: " + std::to_string(board.revealedSafe()));
+        flagsText.setString("flags: " + std::to_string(board.flags()));
+    }
+
+    /**
+     * @brief returns the board tile at a position on screen
+     *
+     */
+    EndlessPos EndlessGame::tileFromScreenPos(const sf::Vector2i& screenPos) const
+    {
+        return {floorDiv(camera.x + screenPos.x, tileSize), floorDiv(camera.y + screenPos.y, tileSize)};
+    }
+
+    // prints the score and how many chunks were made/evicted/stored
+    void EndlessGame::printStats() const
+    {
+        std::cout << "score: " << board.revealedSafe()
+                  << ", chunks made: " << board.chunksMade()
+                  << ", evicted: " << board.chunksEvicted()
+                  << ", in memory: " << board.chunksInMemory()
+                  << ", stored: " << board.store().chunksWritten() << " writes, " << board.store().chunksRead() << " reads\n";
+    }
+};
@@ -10,54 +10,139 @@ namespace game
     }
 
     // Init The Game (should be called before run)
-    bool Game::init(const std::filesystem::path& _tilesetPath, uint16_t tileSize)
+    bool Game::init(const std::filesystem::path& _tilesetPath, uint16_t tileSize,
+                    uint32_t width, uint32_t height, uint32_t mines, uint64_t seed, bool noGuess)
     {
         // Setup Game Fields
+        board.setParallelFlood(&flood);
+        // co-op: the server's board (its size and seed win over the requested ones)
+        const bool joined = !coopHost.empty();
+        if (joined && !coop.connect(coopHost, coopPort, board))
+        {
+            std::cout << "couldn't join " << coopHost << ":" << coopPort << "\n";
+            return false;
+        }
+        // resume the saved game if there is one (its size wins over the requested one)
+        resumed = !joined && !savePath.empty() && saveFile.open(savePath) &&
+                  GameStatus(saveFile.header().status) == GameStatus::playing;
+        if (resumed && !saveFile.restore(board))
+        {
+            std::cout << "save file " << savePath.string() << " is corrupt, starting a new game\n";
+            saveFile.close();
+            resumed = false;
+        }
+        if (joined)
+        {
+            width = board.width();
+            height = board.height();
+            seed = coop.seed();
+            resumedMs = 0;
+            std::cout << "joined " << coopHost << ":" << coopPort << "\n";
+        }
+        else if (resumed)
+        {
+            width = board.width();
+            height = board.height();
+            seed = saveFile.header().seed;
+            resumedMs = int32_t(saveFile.header().elapsedMs);
+            std::cout << "resumed " << savePath.string() << "\n";
+        }
+        else
+        {
+            if (!board.reset(width, height, mines))
+            {
+                std::cout << "board too big: " << width << "x" << height << "\n";
+                return false;
+            }
+            resumedMs = 0;
+        }
         gameFinished = false;
-        gameStarted = false; // game starts only when player open his first tile
-        flags = 0;
+        gameEnded = false;
+        gameStarted = resumed || joined; // game starts only when player open his first tile (server generates it in co-op)
+        // the solver is built on the first hint (its per-tile state is not needed before)
+        solverReady = false;
+        recorder.start({width, height, board.mines(), seed, 1});
+        showHint = false;
+        hintVisible = false;
+        showHeatmap = false;
+        logicShowHint = false;
+        logicShowHeatmap = false;
+        hintFound = false;
+        wasPeeking = false;
+        probabilities.stop();
+        this->seed = seed;
+        this->noGuess = noGuess;
+
+        timerSeconds = 0;
 
         // Setup Window
-        window.create(sf::VideoMode({(unsigned int)(width * tileSize), (unsigned int)(height * tileSize)}), "Minesweeper" );
+        // big boards are scaled down to fit the screen
+        const sf::Vector2u desktopSize = sf::VideoMode::getDesktopMode().size;
+        const float boardWidth = float(width) * tileSize;
+        const float boardHeight = float(height) * tileSize;
+        const float scale = std::min({1.f, desktopSize.x * 0.9f / boardWidth, desktopSize.y * 0.9f / boardHeight});
+        const sf::Vector2u windowSize(std::max(1u, (unsigned int)(boardWidth * scale)),
+                                      std::max(1u, (unsigned int)(boardHeight * scale)));
+        window.create(sf::VideoMode(windowSize), "Minesweeper" );
         window.setFramerateLimit(60);
-        window.setIcon(sf::Image("res/png/mine-icon-256.png"));
+        // icon, font and tileset are decoded once per process (preloaded by main)
+        AssetCache& assets = AssetCache::instance();
+        if (const sf::Image* icon = assets.image(iconPath))
+            window.setIcon(*icon);
 
         // Setup UI (Timer && N_MINES)
-        if (!font.openFromFile("res/fonts/DS-DIGI.TTF"))
+        const sf::Font* font = assets.font(fontPath);
+        if (!font)
             return false;
         clock.reset();
 
         unsigned int textSize = window.getSize().x / 20;
-        timerText.setFont(font);
+        timerText.setFont(*font);
         timerText.setCharacterSize(textSize);
         timerText.setPosition({10u, 5u});
         timerText.setFillColor(sf::Color::Black);
         timerText.setString(std::to_string(clock.getElapsedTime().asMilliseconds() * 1000));
 
-        minesText.setFont(font);
+        minesText.setFont(*font);
         minesText.setCharacterSize(textSize);
         minesText.setPosition({10u, 35u});
         minesText.setFillColor(sf::Color::Red);
-        minesText.setString("mines: " + std::to_string(mines - flags));
+        minesText.setString("mines: " + std::to_string(board.mines() - board.flags()));
+
+#ifdef MINESWEEPER_PROFILER
+        profileText.setFont(*font);
+        profileText.setCharacterSize(std::max(8u, textSize / 2));
+        profileText.setPosition({10.f, 70.f});
+        profileText.setFillColor(sf::Color::Blue);
+        if (showProfile)
+            updateProfileOverlay();
+#endif
         ///////////////////////////////////////////
 
         // Setup Tiles
         tilesetPath = _tilesetPath;
-        Tile tempTile;
-        for (uint16_t i = 0; i < width * height; ++i)
-        {
-            tiles[i] = tempTile;
-            mapIndices[i] = tempTile.getMapIndex();
-        }
         this->tileSize = tileSize;
+        hintMarker.setSize({float(tileSize), float(tileSize)});
 
         
         // Generate level
         // generateLevel(); // moved to first tile click (in handleEvent) to gurantee that first click is not mine
 
-        // Load board
-        return board.load(tilesetPath, {tileSize, tileSize}, mapIndices, width, height);
-        // return true;
+        // Load board (same tileset and size as the last game -> GPU objects are kept, only tiles are rewritten)
+        const sf::Texture* tileset = assets.texture(tilesetPath);
+        // tiles are read from the board directly (the logic thread isn't running yet)
+        if (!tileset || !tilemap.load(*tileset, {tileSize, tileSize}, width, height,
+                                      [this](uint32_t tileIndex1D) { return board.tile(tileIndex1D).getMapIndex(); }))
+            return false;
+        std::cout << "renderer: " << (tilemap.usesShader() ? "shader" : "vertex chunks") << "\n";
+        resetView();
+
+        // save file follows the board, dirty pages are written in the background
+        if (!resumed && !savePath.empty() && !saveFile.create(savePath, board, seed))
+            std::cout << "couldn't create save file " << savePath.string() << "\n";
+        if (saveFile.isOpen())
+            saveFile.startAutosave(std::chrono::milliseconds(autosaveIntervalMs));
+        return true;
     }
 
     /**
@@ -68,252 +153,577 @@ namespace game
      */
     bool Game::run()
     {
+        scheduler.reset();
+        startLogic();
+#ifdef MINESWEEPER_PROFILER
+        frameStartNs = Profiler::now();
+#endif
         while (window.isOpen())
         {
             // handle events
-            while (const std::optional event = window.pollEvent())
-                handleEvent(event);
+            // nothing to draw -> sleep until an event arrives or the timer needs a redraw
+            if (!scheduler.isDirty())
+            {
+                const std::optional event = window.waitEvent(timeUntilWakeUp());
+                scheduler.wokeUp();
+                // a frame is timed from the end of the sleep to the end of display
+#ifdef MINESWEEPER_PROFILER
+                frameStartNs = Profiler::now();
+#endif
+                if (event)
+                {
+                    GAME_PROFILE_SCOPE(events);
+                    handleEvent(event);
+                }
+            }
+            {
+                GAME_PROFILE_SCOPE(events);
+                while (const std::optional event = window.pollEvent())
+                    handleEvent(event);
+            }
+
+            // tiles and state from the logic thread
+            applyLogicUpdates();
 
             // update UI 
             if (!gameFinished && clock.isRunning()){
-                sf::Time elapsedTime = clock.getElapsedTime();
-                // 1second passed
-                if (elapsedTime.asSeconds() - elapsedTime.asMilliseconds() / 1000 > 0.f)
-                    timerText.setString(std::to_string(clock.getElapsedTime().asMilliseconds() / 1000));
+                // redraw timer only when the shown second changes
+                const int32_t seconds = gameTimeMs() / 1000;
+                if (seconds != timerSeconds)
+                {
+                    GAME_PROFILE_SCOPE(hud);
+                    timerSeconds = seconds;
+                    timerText.setString(std::to_string(seconds));
+                    scheduler.markDirty();
+                }
             }
             
             // close game after delay 3.5s from game finish
             // note that clock is restarted at endGame()
-            else if (gameFinished && clock.getElapsedTime().asMilliseconds() >= 3500)
+            else if (gameFinished && clock.getElapsedTime().asMilliseconds() >= endGameDelayMs)
             {
                 window.close();
+                stopLogic();
+                printFrameStats();
                 return true;
             }
 
-            // window drawing
-            window.clear();
-            window.draw(board);
-            window.draw(timerText);
-            window.draw(minesText);
-            window.display();
+#ifdef MINESWEEPER_PROFILER
+            if (showProfile && profileClock.getElapsedTime().asMilliseconds() >= profileRefreshMs)
+                updateProfileOverlay();
+#endif
+
+            if (!scheduler.isDirty())
+                continue;
+
+            // window drawing (board through the zoom/pan view, UI on top)
+            {
+                GAME_PROFILE_SCOPE(draw);
+                window.clear();
+                window.setView(boardView);
+                window.draw(tilemap);
+                if (showHeatmap)
+                    window.draw(heatmap, sf::RenderStates(tilemap.getTransform()));
+                if (hintVisible)
+                    window.draw(hintMarker, sf::RenderStates(tilemap.getTransform()));
+                window.setView(hudView);
+                window.draw(timerText);
+                window.draw(minesText);
+#ifdef MINESWEEPER_PROFILER
+                if (showProfile)
+                    window.draw(profileText);
+#endif
+            }
+            {
+                GAME_PROFILE_SCOPE(display);
+                window.display();
+            }
+            scheduler.frameRendered();
+#ifdef MINESWEEPER_PROFILER
+            // frames drawn back to back (no sleep) start where the previous one ended
+            Profiler& profiler = Profiler::instance();
+            const uint64_t frameEndNs = Profiler::now();
+            profiler.record(ProfileZone::frame, frameStartNs, frameEndNs);
+            profiler.nextFrame();
+            profiler.collect();
+            frameStartNs = frameEndNs;
+#endif
         }
-        // if user closed window before game finish
+        // if user closed window before game finish (board and recorder are ours again once logic stopped)
+        stopLogic();
+        saveRecording();
+        printFrameStats();
         return false;
     }
 
     /**
-     * @brief puts mines in random tiles and updating their neighbours counter
+     * @brief hands a command to the logic thread
      * 
      */
-    void Game::generateLevel(uint16_t firstClickTileIndex)
+    void Game::sendCommand(const Command& command)
     {
-        srand(time(0));
-        uint16_t size = width * height;
-
-        // filling tiles with mines in random positions
-        for (uint16_t mine = 0; mine < mines; ++mine)
+        // full only if the logic thread is stuck on a full tile queue -> drain it meanwhile
+        while (!commands.tryPush(command))
         {
-            uint16_t mineIndex;
-            do
-            {
-                mineIndex = rand() % size;
-                // find another position if position is on firstClicked tile or mine already exist
-            } while (firstClickTileIndex == mineIndex|| tiles[mineIndex].m_isMine); 
-
-            tiles[mineIndex].m_isMine = true;
-            // Update neighbours' counter
-            Tile* neighbours[8];
-            auto counter = getNeighbours8(mineIndex, neighbours);
-            for (uint16_t i = 0; i < counter; i++)
-                neighbours[i]->m_mineCounter++;
+            applyLogicUpdates();
+            std::this_thread::yield();
         }
-        
-        // map tiles to their indices on board
-        for (uint16_t i = 0; i < width * height; i++)
-            mapIndices[i] = tiles[i].getMapIndex();
+        commandsSent++;
+        {
+            // taken so the wake-up can't slip between the logic thread's check and its wait
+            std::lock_guard<std::mutex> lock(logicWakeMutex);
+        }
+        logicWake.notify_one();
     }
 
     /**
-     * @brief update one tile's state
+     * @brief redraws tiles changed by the logic thread and shows its latest state
      * 
-     * @param tileIndex1D index in 1Dim tiles array
-     * @param state tile's new state
      */
-    void Game::updateTile(uint16_t tileIndex1D, const TileState& state)
+    void Game::applyLogicUpdates()
     {
-        tiles[tileIndex1D].m_state = state;
-        board.updateTile(tileIndex1D, tiles[tileIndex1D].getMapIndex());
+        {
+            GAME_PROFILE_SCOPE(updateTile);
+            TileUpdate update;
+            uint32_t applied = 0;
+            while (applied < maxTileUpdatesPerFrame && tileUpdates.tryPop(update))
+            {
+                tilemap.updateTile(update.tileIndex1D, update.mapIndex);
+                // opened tiles lose their color now, the others keep the old estimate until the new one arrives
+                if (showHeatmap && heatmap.getVertexCount() != 0)
+                {
+                    for (uint32_t v = 0; v < 6; ++v)
+                        heatmap[size_t(update.tileIndex1D) * 6 + v].color = sf::Color::Transparent;
+                }
+                applied++;
+            }
+            if (applied > 0)
+                scheduler.markDirty();
+        }
+
+        if (!logicState.update())
+            return;
+        const LogicState& state = logicState.front();
+        {
+            GAME_PROFILE_SCOPE(hud);
+            minesText.setString("mines: " + std::to_string(board.mines() - state.flags));
+        }
+        hintVisible = showHint && state.hintVisible;
+        if (hintVisible)
+        {
+            const sf::Vector2u index2D = Tilemap::convert(state.hint.tileIndex1D, board.width());
+            hintMarker.setPosition({float(index2D.y) * tileSize, float(index2D.x) * tileSize});
+            hintMarker.setFillColor(state.hint.isMine ? sf::Color(255, 0, 0, 96) : sf::Color(0, 255, 0, 96));
+        }
+        if (showHeatmap && state.heatmapVersion != heatmapVersion)
+        {
+            recolorHeatmap(state.heatmap);
+            heatmapVersion = state.heatmapVersion;
+        }
+        // the window closes endGameDelayMs after the logic thread saw the game end
+        if (!gameFinished && (state.status == GameStatus::won || state.status == GameStatus::lost))
+        {
+            gameFinished = true;
+            clock.restart();
+        }
+        scheduler.markDirty();
     }
 
-    /**
-     * @brief update one tile's state
-     * 
-     * @param tilePtr  tile pointer
-     * @param state tile's new state
-     */
-    void Game::updateTile(Tile* tilePtr, const TileState& state)
+    // starts the logic thread
+    void Game::startLogic()
     {
-        if (tilePtr == nullptr)
-            return;
-        tilePtr->m_state = state;
-        uint16_t tileIndex1D = tilePtr - tiles;
-        board.updateTile(tileIndex1D, tiles[tileIndex1D].getMapIndex());
+        // left over from the last game if its window was closed mid-opening
+        tileUpdates.clear();
+        commandsSent = 0;
+        commandsDone = 0;
+        logicStopping = false;
+        logicThread = std::thread(&Game::logicLoop, this);
     }
 
+    // stops the logic thread and waits for it
+    void Game::stopLogic()
+    {
+        if (!logicThread.joinable())
+            return;
+        {
+            std::lock_guard<std::mutex> lock(logicWakeMutex);
+            logicStopping = true;
+        }
+        logicWake.notify_one();
+        logicThread.join();
+    }
 
     /**
-     * @brief Get array of pointers to neighbours of one tile
+     * @brief logic thread: applies commands and co-op updates to the board until stopLogic
      * 
-     * @param tileIndex1D index in 1Dim tiles array
-     * @param neighbours array of pointers (PLEASE MAKE SURE THAT THIS IS ALLOCATED IN MEMORY)
-     * @return uint16_t number of neighbours found (max: 8)
-     * Neighbours can be [down left, left, up left, up, up right, right, down right, down]
      */
-    uint16_t Game::getNeighbours8(const uint16_t tileIndex1D, Tile** neighbours)
+    void Game::logicLoop()
     {
-        sf::Vector2u tileIndex2D = Tilemap::convert(tileIndex1D, width);
-        auto& i = tileIndex2D.x;
-        auto& j = tileIndex2D.y;
-        uint16_t counter = 0;
-        if (i != height - 1)
-        {
-            neighbours[counter] = &tiles[tileIndex1D + width];
-            counter++;
-            if (j != width - 1)
-            {
-                neighbours[counter] = &tiles[tileIndex1D + width + 1]; // down-right
-                counter++;
-            }
-            if (j != 0)
-            {
-                neighbours[counter] = &tiles[tileIndex1D + width - 1]; // down-left
-                counter++;
-            }
-        }
-        if (i != 0)
+        // the render thread may still show the last game's state
+        stateChanged = true;
+        while (!logicStopping)
         {
-            neighbours[counter] = &tiles[tileIndex1D - width]; // up
-            counter++;
-            if (j != 0)
+            Command command;
+            while (!logicStopping && commands.tryPop(command))
             {
-                neighbours[counter] = &tiles[tileIndex1D - width - 1]; // up-left
-                counter++;
+                GAME_PROFILE_SCOPE(logic);
+                handleCommand(command);
+                syncBoard();
+                commandsDone++;
+                stateChanged = true;
             }
-            if (j != width - 1)
+
+            // co-op: the board follows the server (every player's actions)
+            if (coop.isConnected())
             {
-                neighbours[counter] = &tiles[tileIndex1D - width + 1]; // up-right
-                counter++;
+                if (!coop.poll(board))
+                    std::cout << "lost connection to " << coopHost << ":" << coopPort << "\n";
+                syncBoard();
             }
+
+            // new samples -> read the estimate (lock-free)
+            if (logicShowHeatmap && heatmapClock.getElapsedTime().asMilliseconds() >= heatmapRefreshMs &&
+                probabilities.samples() != heatmapSamples)
+                updateHeatmap();
+
+            if (stateChanged)
+                publishState();
+
+            // sleep until the next command (co-op and heatmap are checked every few ms)
+            const int32_t idleMs = coop.isConnected() ? coopPollMs : logicShowHeatmap && probabilities.isRunning() ?
+                                   heatmapRefreshMs : logicIdleMs;
+            std::unique_lock<std::mutex> lock(logicWakeMutex);
+            logicWake.wait_for(lock, std::chrono::milliseconds(idleMs),
+                               [this]() { return logicStopping || !commands.empty(); });
         }
-        if (j != width - 1)
-        {
-            neighbours[counter] = &tiles[tileIndex1D + 1]; // right
-            counter++;
-        }
-        if (j != 0)
-        {
-            neighbours[counter] = &tiles[tileIndex1D - 1]; // left
-            counter++;
-        }
-        return counter;
     }
 
     /**
-     * @brief Get array of pointers to hidden neighbours of one tile
-     * a hidden neighbour: is a tile whose state is TileState::hidden
-     * @param tileIndex1D index in 1Dim tiles array
-     * @param neighbours array of pointers (PLEASE MAKE SURE THAT THIS IS ALLOCATED IN MEMORY)
-     * @return uint16_t number of hidden neighbours found (max: 8)
+     * @brief applies one command to the board
+     * 
      */
-    uint16_t Game::getHiddenNeighbours8(const uint16_t tileIndex1D, Tile** neighbours)
+    void Game::handleCommand(const Command& command)
     {
-        sf::Vector2u tileIndex2D = Tilemap::convert(tileIndex1D, width);
-        auto& i = tileIndex2D.x;
-        auto& j = tileIndex2D.y;
-        uint16_t counter = 0;
-        if (i != height - 1)
-        {
-            Tile* neighbour = &tiles[tileIndex1D + width];
-            if (neighbour->m_state == TileState::hidden || neighbour->m_state == TileState::peek)
-                neighbours[counter++] = neighbour; // down
-            if (j != width - 1)
+        logicTimeMs = command.timeMs;
+        const uint32_t tileIndex1D = command.tileIndex1D;
+        switch (command.type)
+        {
+        // Both Buttons Clicked (Peeking Neighbours)
+        case Command::Type::chord:
+            // to peek neighbours of a tile, the tile must be not-hidden
+            if (board.tile(tileIndex1D).m_state != TileState::notHidden)
+                break;
+            // if user was just peeking neighbours not openning them
+            recordAction(ActionType::chord, tileIndex1D, logicTimeMs);
+            if (peekNeighbours(tileIndex1D))
             {
-                neighbour = &tiles[tileIndex1D + width + 1];
-                if (neighbour->m_state == TileState::hidden || neighbour->m_state == TileState::peek)
-                    neighbours[counter++] = neighbour; // down right
+                wasPeeking = true;
+                tilePeekedIndex1D = tileIndex1D;
             }
+            break;
 
-            if (j != 0)
+        case Command::Type::release:
+            if (wasPeeking)
             {
-                neighbour = &tiles[tileIndex1D + width - 1];
-                if (neighbour->m_state == TileState::hidden || neighbour->m_state == TileState::peek)
-                    neighbours[counter++] = neighbour; // down left
+                board.peek(tilePeekedIndex1D, false);
+                wasPeeking = false;
             }
-            
-        }
-
-        if (i != 0)
-        {
-            Tile* neighbour = &tiles[tileIndex1D - width];
-            if (neighbour->m_state == TileState::hidden || neighbour->m_state == TileState::peek)
-                neighbours[counter++] = neighbour; // up
+            break;
 
-            if (j != 0)
+        // Left Button Clicked (opening/unhiding tile)
+        case Command::Type::reveal:
+            // co-op: the server opens it (the first reveal generates the level there)
+            if (coop.isConnected())
             {
-                neighbour = &tiles[tileIndex1D - width - 1];
-                if (neighbour->m_state == TileState::hidden || neighbour->m_state == TileState::peek)
-                    neighbours[counter++] = &tiles[tileIndex1D - width - 1]; // up-left
+                coop.send(ActionType::reveal, tileIndex1D);
+                break;
             }
-
-            if (j != width - 1)
+            // Player opens first tile
+            if (!gameStarted)
             {
-                neighbour = &tiles[tileIndex1D - width + 1];
-                if (neighbour->m_state == TileState::hidden || neighbour->m_state == TileState::peek)
-                    neighbours[counter++] = &tiles[tileIndex1D - width + 1]; // up-right
+                // first click always opens an empty tile
+                uint64_t levelSeed = seed;
+                if (noGuess)
+                {
+                    NoGuessConfig config;
+                    config.width = board.width();
+                    config.height = board.height();
+                    config.mines = board.mines();
+                    config.firstClick = tileIndex1D;
+                    config.seed = seed;
+                    NoGuessStats stats;
+                    const bool found = generateNoGuess(board, config, stats);
+                    levelSeed = stats.candidateSeed;
+                    recorder.setSeed(levelSeed);
+                    double slowest = 0.0;
+                    for (const CandidateResult& candidate : stats.candidates)
+                        slowest = std::max(slowest, candidate.milliseconds);
+                    std::cout << (found ? "no-guess level" : "no no-guess level in budget, normal level")
+                              << ": " << stats.candidates.size() << " candidates in " << stats.elapsedMs
+                              << " ms (slowest " << slowest << " ms)\n";
+                }
+                else
+                    board.generate(tileIndex1D, seed, 1);
+                // generate changes every tile without reporting them
+                if (saveFile.isOpen())
+                    saveFile.store(board);
+                // the seed that makes this level again (a no-guess level's own seed)
+                std::cout << "seed: " << levelSeed << "\n";
+                gameStarted = true;
             }
+            recordAction(ActionType::reveal, tileIndex1D, logicTimeMs);
+            board.reveal(tileIndex1D);
+            break;
+
+        // Right Button Clicked (setting/unsetting flag)
+        case Command::Type::flag:
+            // co-op: the flag shows up with the server's update
+            if (coop.isConnected())
+                coop.send(ActionType::flag, tileIndex1D);
+            else
+            {
+                recordAction(ActionType::flag, tileIndex1D, logicTimeMs);
+                board.toggleFlag(tileIndex1D);
+            }
+            break;
+
+        case Command::Type::hint:
+            logicShowHint = command.on;
+            updateHint();
+            break;
+
+        case Command::Type::heatmap:
+            logicShowHeatmap = command.on;
+            if (logicShowHeatmap)
+                restartHeatmap();
+            else
+                probabilities.stop();
+            break;
+        }
+    }
+
+    // logic thread: hands the current state to the render thread
+    void Game::publishState()
+    {
+        LogicState& state = logicState.back();
+        state.flags = board.flags();
+        state.status = board.status();
+        state.commandsDone = commandsDone;
+        state.hintVisible = logicShowHint && hintFound;
+        state.hint = hint;
+        state.heatmapSampling = logicShowHeatmap && (probabilities.isRunning() || probabilities.samples() != heatmapSamples);
+        // the buffer holds a value of two publishes ago, the estimate is copied only if it changed since
+        if (state.heatmapVersion != heatmapValuesVersion)
+        {
+            state.heatmap = heatmapValues;
+            state.heatmapVersion = heatmapValuesVersion;
         }
+        logicState.publish();
+        stateChanged = false;
+    }
 
-        if (j != width - 1)
+    /**
+     * @brief time the main loop can sleep waiting for events
+     * 
+     * @return sf::Time time until the next timer second, end-game close or heatmap refresh (Zero -> wait for an event)
+     */
+    sf::Time Game::timeUntilWakeUp() const
+    {
+        sf::Time wakeUp = sf::Time::Zero;
+        if (clock.isRunning())
         {
-            Tile* neighbour = &tiles[tileIndex1D + 1];
-            if (neighbour->m_state == TileState::hidden || neighbour->m_state == TileState::peek)
-                neighbours[counter++] = neighbour; // right
+            const int32_t elapsedMs = clock.getElapsedTime().asMilliseconds();
+            if (gameFinished)
+                wakeUp = sf::milliseconds(std::max(1, endGameDelayMs - elapsedMs));
+            else
+                wakeUp = sf::milliseconds(1000 - gameTimeMs() % 1000);
         }
-        if (j != 0)
+        // the heatmap gets finer while sampling runs
+        if (showHeatmap && logicState.front().heatmapSampling)
         {
-            Tile* neighbour = &tiles[tileIndex1D - 1];
-            if (neighbour->m_state == TileState::hidden || neighbour->m_state == TileState::peek)
-                neighbours[counter++] = neighbour; // left
+            const sf::Time refresh = sf::milliseconds(heatmapRefreshMs);
+            wakeUp = wakeUp == sf::Time::Zero ? refresh : std::min(wakeUp, refresh);
         }
-        return counter;
+        // the logic thread is still on a command or tiles are left for the next frames
+        if (logicState.front().commandsDone != commandsSent || !tileUpdates.empty())
+        {
+            const sf::Time refresh = sf::milliseconds(pendingFrameMs);
+            wakeUp = wakeUp == sf::Time::Zero ? refresh : std::min(wakeUp, refresh);
+        }
+        // other players may change the board any time
+        if (!coopHost.empty())
+        {
+            const sf::Time refresh = sf::milliseconds(coopPollMs);
+            wakeUp = wakeUp == sf::Time::Zero ? refresh : std::min(wakeUp, refresh);
+        }
+#ifdef MINESWEEPER_PROFILER
+        if (showProfile)
+        {
+            const sf::Time refresh = sf::milliseconds(std::max(1, profileRefreshMs - profileClock.getElapsedTime().asMilliseconds()));
+            wakeUp = wakeUp == sf::Time::Zero ? refresh : std::min(wakeUp, refresh);
+        }
+#endif
+        return wakeUp;
     }
 
-    void Game::handleEvent(const std::optional<sf::Event>& event)
+    /**
+     * @brief prints how many frames were drawn and skipped (vs. drawing every frame)
+     * 
+     */
+    void Game::printFrameStats() const
     {
-        static bool wasPeeking = false;
-        static uint16_t tilePeekedIndex1D = 0;
-        // last hovered tile
+        std::cout << "frames rendered: " << scheduler.framesRendered()
+                  << ", skipped: " << scheduler.framesSkipped()
+                  << ", wake-ups: " << scheduler.wakeups() << "\n";
+#ifdef MINESWEEPER_PROFILER
+        Profiler& profiler = Profiler::instance();
+        profiler.flushCsv();
+        const Profiler::Percentiles frame = profiler.percentiles(ProfileZone::frame);
+        std::cout << "frame time p50: " << frame.p50Ms << " ms, p99: " << frame.p99Ms << " ms";
+        if (!profilePath.empty())
+            std::cout << ", profile: " << profilePath.string() << " (" << profiler.csvSamples() << " samples)";
+        if (profiler.dropped() > 0)
+            std::cout << ", dropped: " << profiler.dropped();
+        std::cout << "\n";
+#endif
+    }
 
+#ifdef MINESWEEPER_PROFILER
+    /**
+     * @brief writes the frame profile to a CSV file, flushed when run returns
+     * 
+     */
+    void Game::setProfilePath(const std::filesystem::path& path)
+    {
+        profilePath = path;
+        if (!path.empty() && !Profiler::instance().openCsv(path))
+        {
+            std::cout << "couldn't create profile " << path.string() << "\n";
+            profilePath.clear();
+        }
+    }
+
+    // rewrites the profiler overlay with the p50/p99 time of every zone
+    void Game::updateProfileOverlay()
+    {
+        Profiler& profiler = Profiler::instance();
+        profiler.collect();
+        std::ostringstream text;
+        text << std::fixed << std::setprecision(2);
+        for (uint8_t zone = 0; zone < uint8_t(ProfileZone::count); ++zone)
+        {
+            const Profiler::Percentiles times = profiler.percentiles(ProfileZone(zone));
+            text << Profiler::zoneName(ProfileZone(zone)) << "  p50 " << times.p50Ms << "  p99 " << times.p99Ms << " ms\n";
+        }
+        profileText.setString(text.str());
+        profileClock.restart();
+        scheduler.markDirty();
+    }
+#endif
+
+    void Game::handleEvent(const std::optional<sf::Event>& event)
+    {
         if (event->is<sf::Event::Closed>())
             window.close();
 
-        else if (const auto* mouse = event->getIf<sf::Event::MouseButtonReleased>())
+        else if (const auto* resized = event->getIf<sf::Event::Resized>())
         {
-            if (wasPeeking)
+            // keep the zoom level, show more/less of the board
+            const sf::Vector2f oldSize = hudView.getSize();
+            const sf::Vector2f newSize = sf::Vector2f(resized->size);
+            boardView.setSize({boardView.getSize().x * newSize.x / oldSize.x, boardView.getSize().y * newSize.y / oldSize.y});
+            hudView = sf::View(sf::FloatRect({0.f, 0.f}, newSize));
+            scheduler.markDirty();
+        }
+
+        // window contents may have been lost while it was hidden
+        else if (event->is<sf::Event::FocusGained>() || event->is<sf::Event::MouseEntered>())
+            scheduler.markDirty();
+
+        else if (const auto* wheel = event->getIf<sf::Event::MouseWheelScrolled>())
+            zoomView(wheel->delta > 0 ? 1.f / zoomStep : zoomStep, wheel->position);
+
+        else if (const auto* key = event->getIf<sf::Event::KeyPressed>())
+        {
+            // arrows/WASD pan by a quarter of the view, +/- zoom, Home shows the whole board
+            const sf::Vector2f step = boardView.getSize() / 4.f;
+            if (key->code == sf::Keyboard::Key::Left || key->code == sf::Keyboard::Key::A)
+                panView({-step.x, 0.f});
+            else if (key->code == sf::Keyboard::Key::Right || key->code == sf::Keyboard::Key::D)
+                panView({step.x, 0.f});
+            else if (key->code == sf::Keyboard::Key::Up || key->code == sf::Keyboard::Key::W)
+                panView({0.f, -step.y});
+            else if (key->code == sf::Keyboard::Key::Down || key->code == sf::Keyboard::Key::S)
+                panView({0.f, step.y});
+            else if (key->code == sf::Keyboard::Key::Add || key->code == sf::Keyboard::Key::Equal)
+                zoomView(1.f / zoomStep, sf::Vector2i(window.getSize() / 2u));
+            else if (key->code == sf::Keyboard::Key::Subtract || key->code == sf::Keyboard::Key::Hyphen)
+                zoomView(zoomStep, sf::Vector2i(window.getSize() / 2u));
+            else if (key->code == sf::Keyboard::Key::Home)
+                resetView();
+            // H shows/hides a tile the solver proved safe (or mined)
+            else if (key->code == sf::Keyboard::Key::H)
+            {
+                showHint = !showHint;
+                sendCommand({Command::Type::hint, 0, gameTimeMs(), showHint});
+            }
+#ifdef MINESWEEPER_PROFILER
+            // F3 shows/hides the frame time percentiles
+            else if (key->code == sf::Keyboard::Key::F3)
             {
-                Tile* neighborus[8];
-                auto counter = getNeighbours8(tilePeekedIndex1D, neighborus);
-                for (uint16_t i = 0; i < counter; i++)
+                showProfile = !showProfile;
+                if (showProfile)
+                    updateProfileOverlay();
+                scheduler.markDirty();
+            }
+#endif
+            // P shows/hides the estimated mine probability of every hidden tile
+            else if (key->code == sf::Keyboard::Key::P)
+            {
+                if (board.size() > heatmapMaxTiles)
                 {
-                    if (neighborus[i]->m_state == TileState::peek)
-                        updateTile(neighborus[i], TileState::hidden);
+                    std::cout << "no heatmap on boards bigger than " << heatmapMaxTiles << " tiles\n";
+                    return;
                 }
-                wasPeeking = false;
+                showHeatmap = !showHeatmap;
+                // colors come with the logic thread's first estimate
+                if (showHeatmap)
+                    buildHeatmap();
+                sendCommand({Command::Type::heatmap, 0, gameTimeMs(), showHeatmap});
+                scheduler.markDirty();
             }
         }
 
+        else if (const auto* moved = event->getIf<sf::Event::MouseMoved>())
+        {
+            // drag the board while middle button is held
+            if (panning)
+            {
+                const sf::Vector2f from = window.mapPixelToCoords(panLastPos, boardView);
+                const sf::Vector2f to = window.mapPixelToCoords(moved->position, boardView);
+                panView(from - to);
+                panLastPos = moved->position;
+            }
+        }
+
+        else if (const auto* mouse = event->getIf<sf::Event::MouseButtonReleased>())
+        {
+            if (mouse->button == sf::Mouse::Button::Middle)
+                panning = false;
+            else
+                sendCommand({Command::Type::release, 0, gameTimeMs(), false});
+        }
+
         else if (const auto* mouse = event->getIf<sf::Event::MouseButtonPressed>())
         {
+            // middle button drags the board
+            if (mouse->button == sf::Mouse::Button::Middle)
+            {
+                panning = true;
+                panLastPos = mouse->position;
+                return;
+            }
+
             // start timer on user's first presss
             if (!clock.isRunning())
                 clock.start();
@@ -323,75 +733,16 @@ namespace game
             bool right = sf::Mouse::isButtonPressed(sf::Mouse::Button::Right);
 
             auto tileIndex1D = tileIndexFromScreenPos(mouse->position);
+            if (tileIndex1D >= board.size())
+                return;
 
-            // Both Buttons Clicked (Peeking Neighbours)
+            // the logic thread applies it, changed tiles come back with applyLogicUpdates
             if (left && right)
-            {
-                // to peek neighbours of a tile, the tile must be not-hidden
-                if (tiles[tileIndex1D].m_state != TileState::notHidden)
-                    return;
-                // if user was just peeking neighbours not openning them
-                if (peekNeighbours(tileIndex1D))
-                    tilePeekedIndex1D = tileIndex1D;
-
-            }
-
-            // Left Button Clicked (opening/unhiding tile)
+                sendCommand({Command::Type::chord, tileIndex1D, gameTimeMs(), false});
             else if (left)
-            {
-                // Player opens first tile
-                if (!gameStarted)
-                {
-                    generateLevel(tileIndex1D);
-                    if (!board.load(tilesetPath, {tileSize, tileSize}, mapIndices, width, height))
-                    {
-                        gameFinished = true;
-                        return;
-                    }
-                    gameStarted = true;
-                }
-                // ignore clicking on already-openned tiles
-                else if (tiles[tileIndex1D].m_state == TileState::notHidden)
-                    return;
-                // player opens a mine -> Loses
-                else if (tiles[tileIndex1D].m_isMine)
-                {
-                    updateTile(tileIndex1D, TileState::mineClicked);
-                    endGame(false);
-                    return;
-                }
-                // player opens a non-mined tile
-                updateTile(tileIndex1D, TileState::notHidden);
-                // player opens an empty tile
-                if (tiles[tileIndex1D].m_mineCounter == 0)
-                    unhideEmptyNeighbours(tileIndex1D);
-            }
-
-            // Right Button Clicked (setting/unsetting flag)
+                sendCommand({Command::Type::reveal, tileIndex1D, gameTimeMs(), false});
             else if (right)
-            {
-                // ignore right-clicking on openned tile
-                if (tiles[tileIndex1D].m_state == TileState::notHidden)
-                    return;
-
-                // unsetting a flag
-                if (tiles[tileIndex1D].m_state == TileState::flagged)
-                {
-                    updateTile(tileIndex1D, TileState::hidden);
-                    flags--;
-                    minesText.setString("mines: " + std::to_string(mines - flags));
-                    return;
-                }
-                // setting a flag
-                updateTile(tileIndex1D, TileState::flagged);
-                flags++;
-                minesText.setString("mines: " + std::to_string(mines - flags));
-
-                // if player uses all their flags - endGame
-                // if all flags on all mines, then win, else lose
-                if (flags == mines)
-                    endGame(checkWin());
-            }
+                sendCommand({Command::Type::flag, tileIndex1D, gameTimeMs(), false});
         }
     }
 
@@ -402,143 +753,252 @@ namespace game
      * @return true user was peeking not openning tiles -- this sets the wasPeeking state to true
      * @return false user was openning tiles -- don't set wasPeeking state
      */
-    bool Game::peekNeighbours(uint16_t tileIndex1D)
+    bool Game::peekNeighbours(uint32_t tileIndex1D)
     {
-        Tile* neighbours[8];
-        auto counter = getNeighbours8(tileIndex1D, neighbours);
-
-        uint16_t flagCounter = 0;
-        bool flagNotOnMine = false;
-
         // peek on hidden neighbours
-        for (uint16_t i = 0; i < counter; i++)
-        {
-            if (neighbours[i]->m_state == TileState::hidden)
-                updateTile(neighbours[i], TileState::peek);
+        board.peek(tileIndex1D, true);
 
-            // check neighbours with flags
-            else if (neighbours[i]->m_state == TileState::flagged)
-            {
-                flagCounter++;
-                // if player puts a flag on a not-mined tile
-                // there's possibility that player loses
-                if (!(neighbours[i]->m_isMine))
-                    flagNotOnMine = true;
-            }
-        }
-
-        // player was just peeking neighbours (not to open them)
-        if (flagCounter < tiles[tileIndex1D].m_mineCounter)
+        // co-op: the server opens them (or not), they stay peeked until the buttons are released
+        if (coop.isConnected())
+        {
+            coop.send(ActionType::chord, tileIndex1D);
             return true;
+        }
 
         // no. of neighbours with flags >= tile number itself
         // then player is not peeking, but opening all neighbours
-        // ---------------------------
+        return !board.chord(tileIndex1D);
+    }
 
-        // a flag was on wrong tile, and the player tries to open
-        // the tile, then player loses.
-        if (flagNotOnMine)
-        {
-            endGame(false);
+    /**
+     * @brief sends tiles changed by the last board action to the render thread and ends the game if board is finished
+     * 
+     */
+    void Game::syncBoard()
+    {
+        if (board.changes().empty())
             return;
+        for (uint32_t tileIndex1D : board.changes())
+        {
+            // the render thread drains the queue every frame, a full queue only waits for the next one
+            const TileUpdate update {tileIndex1D, board.tile(tileIndex1D).getMapIndex()};
+            while (!tileUpdates.tryPush(update))
+            {
+                if (logicStopping)
+                    return;
+                std::this_thread::yield();
+            }
         }
+        // solver only re-examines numbers around the changed tiles
+        if (solverReady)
+            solver.update(board.changes());
+        saveFile.update(board, board.changes(), uint32_t(logicTimeMs));
+        // the others keep the old estimate until the new one arrives
+        if (logicShowHeatmap)
+            restartHeatmap();
+        board.clearChanges();
+        updateHint();
+        stateChanged = true;
+
+        if (!gameEnded && board.isFinished())
+            endGame(board.status() == GameStatus::won);
+    }
 
-        // opening non-mined neighbours
-        // since player guessed the mines by putting flags correct
-        for (uint16_t i = 0; i < counter; i++)
+    /**
+     * @brief finds the solver's next deduction for the hint marker
+     * 
+     */
+    void Game::updateHint()
+    {
+        // first hint of the game: the solver catches up with the tiles opened so far
+        if (logicShowHint && !solverReady)
         {
-            Tile* neighbour = neighbours[i];
-            // skip mined-tiles
-            if (neighbour->m_isMine)
-                continue;
-            // otherwise open the tile
-            updateTile(neighbours[i], TileState::notHidden);
-            // if neighbour is empty, unhide all neighbour's neighbours !
-            if (neighbour->m_mineCounter == 0)
-                unhideEmptyNeighbours(neighbours[i] - tiles);
+            solver.reset(board);
+            solverReady = true;
         }
+        hintFound = logicShowHint && !board.isFinished() && solver.hint(hint);
+        stateChanged = true;
     }
 
     /**
-     * @brief opens/unhides non-mined neighbours of a given tile
+     * @brief (re)starts the mine probability estimate of the heatmap from the current board
      * 
-     * @param index1D index in 1Dim tiles array
      */
-    void Game::unhideEmptyNeighbours(uint16_t index1D)
+    void Game::restartHeatmap()
     {
-        Tile* neighbours[8];
-        uint16_t count = getHiddenNeighbours8(index1D, neighbours);
-        
-        for (uint16_t i = 0; i < count; ++i)
-        {
-            // don't open mined neighbours
-            if (neighbours[i]->m_isMine)
-                continue;
-            
-            updateTile(neighbours[i], TileState::notHidden);
+        // sampling runs on the pool, the logic thread only reads the counts
+        probabilities.start(board, seed);
+        heatmapSamples = 0;
+        heatmapClock.restart();
+        // finished board: nothing to estimate, clear the colors
+        if (!probabilities.isRunning())
+            updateHeatmap();
+    }
+
+    /**
+     * @brief reads the latest estimate for the heatmap
+     * 
+     */
+    void Game::updateHeatmap()
+    {
+        heatmapSamples = probabilities.samples();
+        heatmapClock.restart();
+        probabilities.read(heatmapValues);
+        heatmapValuesVersion++;
+        stateChanged = true;
+    }
 
-            // recursively unhide empty neighbours if current
-            // negihbour is empty (has no mined neighbour)
-            if (neighbours[i]->m_mineCounter == 0)
-                unhideEmptyNeighbours(neighbours[i] - tiles);
+    /**
+     * @brief builds one transparent quad per tile for the heatmap
+     * 
+     */
+    void Game::buildHeatmap()
+    {
+        // one quad per tile, only colors change afterwards
+        if (heatmap.getVertexCount() != size_t(board.size()) * 6)
+        {
+            heatmap.resize(size_t(board.size()) * 6);
+            for (uint32_t i = 0; i < board.size(); ++i)
+            {
+                const sf::Vector2u index2D = Tilemap::convert(i, board.width());
+                const float left = float(index2D.y) * tileSize;
+                const float top = float(index2D.x) * tileSize;
+                const float right = left + tileSize;
+                const float bottom = top + tileSize;
+                sf::Vertex* quad = &heatmap[size_t(i) * 6];
+                quad[0].position = {left, top};
+                quad[1].position = {right, top};
+                quad[2].position = {left, bottom};
+                quad[3].position = {left, bottom};
+                quad[4].position = {right, top};
+                quad[5].position = {right, bottom};
+            }
         }
+        for (size_t v = 0; v < heatmap.getVertexCount(); ++v)
+            heatmap[v].color = sf::Color::Transparent;
     }
 
     /**
-     * @brief check if player win 
+     * @brief recolors the heatmap
      * 
-     * @return false if any tile with a flag is not mined or vice versa
-     * @return true when all mined tiles are flagged and vice versa
      */
-    bool Game::checkWin()
+    void Game::recolorHeatmap(const std::vector<float>& values)
     {
-        for (uint16_t i = 0; i < width * height; ++i)
+        for (uint32_t i = 0; i < board.size(); ++i)
         {
-            bool isMined = tiles[i].m_isMine;
-            bool isFlagged = tiles[i].m_state == TileState::flagged;
-            if (isMined && !isFlagged || !isMined && isFlagged)
-                return false;
+            // -1 (opened tile or finished game) -> transparent
+            const float probability = i < values.size() ? values[i] : -1.f;
+            const sf::Color color = probability < 0.f ? sf::Color::Transparent :
+                                    sf::Color(uint8_t(255 * probability), uint8_t(255 * (1.f - probability)), 0, 110);
+            for (uint32_t v = 0; v < 6; ++v)
+                heatmap[size_t(i) * 6 + v].color = color;
         }
-        return true;
+        scheduler.markDirty();
     }
 
     /**
-     * @brief Ends the game, opens all hidden-mines and resets clock/timer
+     * @brief Ends the game: prints the result and saves the recording
      * 
      * @param userWon whether user won or not
      */
     void Game::endGame(bool userWon)
     {
-        // resetting timer and game state
-        gameFinished = true;
-        clock.restart();
+        gameEnded = true;
+        probabilities.stop();
 
         std::cout << (userWon ? "win" : "lose") << "\n";
+        saveRecording();
+    }
 
-        // open all mines to let player know where were the mines
-        for (uint16_t i = 0; i < width * height; ++i)
-        {
-            if (tiles[i].m_state != TileState::mineClicked && tiles[i].m_isMine)
-                updateTile(i, TileState::notHidden);
-        }
+    /**
+     * @brief records an action with the game clock time (before it is applied)
+     * 
+     */
+    void Game::recordAction(ActionType type, uint32_t tileIndex1D, int32_t timeMs)
+    {
+        recorder.record({type, tileIndex1D}, uint32_t(timeMs));
+    }
+
+    // finishes the recording with the board state and writes it (if a recording path is set)
+    void Game::saveRecording()
+    {
+        // a resumed game can't be replayed from its first click
+        if (recordingPath.empty() || recorder.isFinished() || resumed)
+            return;
+        recorder.finish(board);
+        if (recorder.save(recordingPath))
+            std::cout << "recording: " << recordingPath.string() << " (" << recorder.bytes().size() << " bytes)\n";
+        else
+            std::cout << "couldn't write recording " << recordingPath.string() << "\n";
+    }
+
+    /**
+     * @brief shows the whole board
+     * 
+     */
+    void Game::resetView()
+    {
+        const sf::Vector2f boardSize = tilemap.getPixelSize();
+        const sf::Vector2f windowSize = sf::Vector2f(window.getSize());
+        hudView = sf::View(sf::FloatRect({0.f, 0.f}, windowSize));
+
+        // fit board in window keeping tiles square
+        const float scale = std::max(boardSize.x / windowSize.x, boardSize.y / windowSize.y);
+        boardView = sf::View(boardSize / 2.f, windowSize * scale);
+        scheduler.markDirty();
+    }
+
+    /**
+     * @brief zooms the board view keeping the board point under the cursor in place
+     * 
+     * @param factor view size multiplier (< 1 zooms in)
+     * @param screenPos zoom center in window pixels
+     */
+    void Game::zoomView(float factor, const sf::Vector2i& screenPos)
+    {
+        const sf::Vector2f boardSize = tilemap.getPixelSize();
+        const sf::Vector2f viewSize = boardView.getSize();
+        // at least 4 tiles visible, zoom out until the whole board fits twice
+        const float minWidth = 4.f * tileSize;
+        const float maxWidth = std::max(minWidth, 2.f * std::max(boardSize.x, boardSize.y * viewSize.x / viewSize.y));
+        factor = std::clamp(factor, minWidth / viewSize.x, maxWidth / viewSize.x);
+
+        const sf::Vector2f before = window.mapPixelToCoords(screenPos, boardView);
+        boardView.zoom(factor);
+        const sf::Vector2f after = window.mapPixelToCoords(screenPos, boardView);
+        boardView.move(before - after);
+        scheduler.markDirty();
+    }
+
+    /**
+     * @brief moves the board view (center stays on the board)
+     * 
+     * @param offset offset in board pixels
+     */
+    void Game::panView(const sf::Vector2f& offset)
+    {
+        const sf::Vector2f boardSize = tilemap.getPixelSize();
+        const sf::Vector2f center = boardView.getCenter() + offset;
+        boardView.setCenter({std::clamp(center.x, 0.f, boardSize.x), std::clamp(center.y, 0.f, boardSize.y)});
+        scheduler.markDirty();
     }
 
     /**
      * @brief returns tileIndex in 1-D array of given position on screen
      * 
      * @param screenPos screen position (according to sfml)
-     * @return uint16_t index of tile in 1D array 
+     * @return uint32_t index of tile in 1D array (board size if position is outside the board)
      */
-    uint16_t Game::tileIndexFromScreenPos(const sf::Vector2i& screenPos)
+    uint32_t Game::tileIndexFromScreenPos(const sf::Vector2i& screenPos)
     {
-        const auto& x = screenPos.x;
-        const auto& y = screenPos.y;
-        const auto windowSize = window.getSize();
-        if (x < 0 || y < 0 || x >= windowSize.x || y >= windowSize.y)
-            return {};
-        const auto currTileSize = sf::Vector2u(windowSize.y / width, windowSize.x / height);
-        sf::Vector2u index2d = sf::Vector2u(y / currTileSize.x, x / currTileSize.y);
-        return Tilemap::convert(index2d, width);
+        // undo board view (zoom/pan) and board transform -> position in tileset pixels
+        const sf::Vector2f boardPos = tilemap.getInverseTransform().transformPoint(window.mapPixelToCoords(screenPos, boardView));
+        if (boardPos.x < 0.f || boardPos.y < 0.f)
+            return board.size();
+        const sf::Vector2u index2d = sf::Vector2u(unsigned(boardPos.y) / tileSize, unsigned(boardPos.x) / tileSize);
+        if (index2d.x >= board.height() || index2d.y >= board.width())
+            return board.size();
+        return Tilemap::convert(index2d, board.width());
     }
 
 };
\ No newline at end of file
@@ -0,0 +1,134 @@
+// Generator.cpp
+#include <Generator.h>
+#include <Random.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace game
+{
+    /**
+     * @brief seed of one candidate board
+     *
+     */
+    uint64_t candidateSeed(uint64_t seed, uint64_t index)
+    {
+        // index-th output of a splitmix64 stream started at seed
+        uint64_t state = seed + index * 0x9e3779b97f4a7c15ull;
+        return Random::splitmix64(state);
+    }
+
+    /**
+     * @brief plays a board from the first click with only the solver's deductions
+     *
+     */
+    CandidateOutcome solveWithoutGuessing(Board& board, Solver& solver, uint32_t firstClick,
+                                          const std::function<bool()>& cancelled)
+    {
+        solver.reset(board);
+        board.reveal(firstClick);
+        uint32_t opened = uint32_t(board.revealed().size());
+        solver.update(board.revealed());
+
+        const uint32_t safeTiles = board.size() - board.mines();
+        Hint hint;
+        while (opened < safeTiles && !board.isFinished())
+        {
+            if (cancelled && cancelled())
+                return CandidateOutcome::cancelled;
+            // solver is stuck -> player would have to guess
+            if (!solver.hint(hint))
+                return CandidateOutcome::needsGuess;
+            if (hint.isMine)
+            {
+                // flags don't help the solver, they only take the mine out of the hints
+                board.toggleFlag(hint.tileIndex1D);
+                continue;
+            }
+            board.reveal(hint.tileIndex1D);
+            opened += uint32_t(board.revealed().size());
+            solver.update(board.revealed());
+        }
+        // all flags on mines ends the game as a win too
+        return board.status() == GameStatus::lost ? CandidateOutcome::needsGuess : CandidateOutcome::solved;
+    }
+
+    /**
+     * @brief generates a level that needs no guess, trying candidates on all cores
+     *
+     */
+    bool generateNoGuess(Board& board, const NoGuessConfig& config, NoGuessStats& stats)
+    {
+        using Clock = std::chrono::steady_clock;
+        const Clock::time_point start = Clock::now();
+        const Clock::time_point deadline = start +
+            std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(config.budgetMs));
+
+        const uint32_t threadCount = config.threads != 0 ? config.threads :
+            std::max(1u, std::thread::hardware_concurrency());
+        std::atomic<uint64_t> nextCandidate {0};
+        // lowest solved candidate so far, candidates above it are cancelled
+        // (lower ones still running at the deadline are cancelled too, the result then depends on timing)
+        std::atomic<uint64_t> best {UINT64_MAX};
+        std::vector<std::vector<CandidateResult>> results(threadCount);
+
+        auto worker = [&](uint32_t thread)
+        {
+            Board candidate;
+            candidate.setHeadless(true);
+            Solver solver;
+            uint64_t index = 0;
+            // only candidates below best can still win
+            auto cancelled = [&]() { return index > best.load(std::memory_order_relaxed) || Clock::now() >= deadline; };
+
+            while (true)
+            {
+                index = nextCandidate.fetch_add(1, std::memory_order_relaxed);
+                if (cancelled())
+                    break;
+
+                const Clock::time_point candidateStart = Clock::now();
+                candidate.reset(config.width, config.height, config.mines);
+                candidate.generate(config.firstClick, candidateSeed(config.seed, index), config.safeRadius);
+                const CandidateOutcome outcome = solveWithoutGuessing(candidate, solver, config.firstClick, cancelled);
+                const double milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - candidateStart).count();
+                results[thread].push_back({index, milliseconds, outcome});
+
+                if (outcome == CandidateOutcome::solved)
+                {
+                    uint64_t current = best.load(std::memory_order_relaxed);
+                    while (index < current && !best.compare_exchange_weak(current, index, std::memory_order_relaxed))
+                        ;
+                }
+            }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(threadCount - 1);
+        for (uint32_t thread = 1; thread < threadCount; ++thread)
+            threads.emplace_back(worker, thread);
+        worker(0);
+        for (std::thread& thread : threads)
+            thread.join();
+
+        // merge per-thread results in candidate order
+        stats.candidates.clear();
+        for (const auto& threadResults : results)
+            stats.candidates.insert(stats.candidates.end(), threadResults.begin(), threadResults.end());
+        std::sort(stats.candidates.begin(), stats.candidates.end(),
+                  [](const CandidateResult& a, const CandidateResult& b) { return a.index < b.index; });
+
+        // out of budget -> a normal level, still playable
+        stats.found = best.load() != UINT64_MAX;
+        stats.candidateIndex = stats.found ? best.load() : 0;
+        stats.candidateSeed = stats.found ? candidateSeed(config.seed, stats.candidateIndex) : config.seed;
+        // flags put before the first click stay (generate counts them like a normal first click does)
+        if (board.width() != config.width || board.height() != config.height || board.mines() != config.mines ||
+            board.status() != GameStatus::notStarted)
+            board.reset(config.width, config.height, config.mines);
+        board.generate(config.firstClick, stats.candidateSeed, config.safeRadius);
+        stats.elapsedMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        return stats.found;
+    }
+};
@@ -0,0 +1,209 @@
+// ParallelFlood.cpp
+#include <ParallelFlood.h>
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+
+namespace game
+{
+    namespace
+    {
+        // hidden (or peeked) empty tile: it is opened and spreads the opening
+        bool spreads(const Tile& tile)
+        {
+            return !tile.m_isMine && tile.m_mineCounter == 0 &&
+                   (tile.m_state == TileState::hidden || tile.m_state == TileState::peek);
+        }
+
+        // hidden (or peeked) safe tile (sentinels are neither)
+        bool openable(const Tile& tile)
+        {
+            return !tile.m_isMine && (tile.m_state == TileState::hidden || tile.m_state == TileState::peek);
+        }
+    }
+
+    ParallelFlood::ParallelFlood(ThreadPool& pool)
+        : m_pool(pool)
+    {
+
+    }
+
+    // runs task(strip) for every strip on the pool and waits for all of them
+    template <typename Task>
+    void ParallelFlood::forEachStrip(uint32_t strips, const Task& task)
+    {
+        std::mutex mutex;
+        std::condition_variable finished;
+        uint32_t remaining = strips;
+        for (uint32_t strip = 0; strip < strips; ++strip)
+        {
+            m_pool.submit([&, strip]()
+            {
+                task(strip);
+                std::lock_guard<std::mutex> lock(mutex);
+                if (--remaining == 0)
+                    finished.notify_one();
+            });
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [&remaining]() { return remaining == 0; });
+    }
+
+    // root of a label, halving the path on the way (safe while other threads unite)
+    uint32_t ParallelFlood::findRoot(uint32_t label)
+    {
+        while (true)
+        {
+            uint32_t parent = m_parents[label].load(std::memory_order_relaxed);
+            if (parent == label)
+                return label;
+            const uint32_t grandParent = m_parents[parent].load(std::memory_order_relaxed);
+            // skipping to an ancestor never breaks the tree, losing the race only skips the shortcut
+            if (grandParent != parent)
+                m_parents[label].compare_exchange_weak(parent, grandParent, std::memory_order_relaxed);
+            label = grandParent;
+        }
+    }
+
+    // merges the regions of two labels: the bigger root is linked under the smaller one
+    void ParallelFlood::unite(uint32_t a, uint32_t b)
+    {
+        while (true)
+        {
+            a = findRoot(a);
+            b = findRoot(b);
+            if (a == b)
+                return;
+            if (a < b)
+                std::swap(a, b);
+            // a may have been linked by another thread meanwhile -> retry from the new roots
+            uint32_t expected = a;
+            if (m_parents[a].compare_exchange_strong(expected, b, std::memory_order_acq_rel))
+                return;
+        }
+    }
+
+    /**
+     * @brief opens the empty region of a tile and the tiles around it
+     *
+     */
+    void ParallelFlood::reveal(Tile* tiles, uint32_t width, uint32_t height, uint32_t start, std::vector<uint32_t>& opened)
+    {
+        const uint32_t stride = width + 2;
+        const size_t paddedSize = size_t(stride) * (height + 2);
+        if (m_capacity < paddedSize)
+        {
+            m_parents.reset(new std::atomic<uint32_t>[paddedSize]);
+            m_capacity = paddedSize;
+        }
+        m_inRegion.assign(paddedSize, 0);
+
+        const uint32_t strips = std::max(1u, std::min(m_pool.size() * stripsPerWorker, height / minStripRows));
+        const uint32_t rowsPerStrip = (height + strips - 1) / strips;
+        m_opened.resize(strips);
+        // first and last padded row of a strip (rows 1..height hold the tiles)
+        auto firstRow = [&](uint32_t strip) { return 1 + std::min(height, strip * rowsPerStrip); };
+        auto endRow = [&](uint32_t strip) { return 1 + std::min(height, (strip + 1) * rowsPerStrip); };
+
+        // 1. every strip labels its empty tiles from the tiles left, up-left, up and up-right of them
+        // (without looking above its first row); the tile above touches the 3 others, so it decides alone
+        forEachStrip(strips, [&](uint32_t strip)
+        {
+            for (uint32_t row = firstRow(strip); row < endRow(strip); ++row)
+            {
+                const bool top = row == firstRow(strip);
+                // the border around the row is never empty
+                m_parents[row * stride].store(none, std::memory_order_relaxed);
+                m_parents[row * stride + width + 1].store(none, std::memory_order_relaxed);
+                for (uint32_t cell = row * stride + 1, end = cell + width; cell < end; ++cell)
+                {
+                    if (!spreads(tiles[cell]))
+                    {
+                        m_parents[cell].store(none, std::memory_order_relaxed);
+                        continue;
+                    }
+                    const uint32_t up = top ? none : m_parents[cell - stride].load(std::memory_order_relaxed);
+                    uint32_t label = cell;
+                    if (up != none)
+                        label = findRoot(cell - stride);
+                    else
+                    {
+                        const uint32_t upRight = top ? none : m_parents[cell - stride + 1].load(std::memory_order_relaxed);
+                        const uint32_t upLeft = top ? none : m_parents[cell - stride - 1].load(std::memory_order_relaxed);
+                        const uint32_t left = m_parents[cell - 1].load(std::memory_order_relaxed);
+                        if (left != none)
+                            label = findRoot(cell - 1);
+                        else if (upLeft != none)
+                            label = findRoot(cell - stride - 1);
+                        // up-right doesn't touch left nor up-left: 2 regions may meet here
+                        if (upRight != none)
+                        {
+                            if (label != cell)
+                                unite(label, cell - stride + 1);
+                            else
+                                label = findRoot(cell - stride + 1);
+                        }
+                    }
+                    m_parents[cell].store(label, std::memory_order_relaxed);
+                }
+            }
+        });
+
+        // 2. merge the regions that touch across each strip border (first row of a strip and the row above)
+        forEachStrip(strips, [&](uint32_t strip)
+        {
+            const uint32_t row = firstRow(strip);
+            if (strip == 0 || row >= endRow(strip))
+                return;
+            for (uint32_t cell = row * stride + 1, end = cell + width; cell < end; ++cell)
+            {
+                if (m_parents[cell].load(std::memory_order_relaxed) == none)
+                    continue;
+                for (uint32_t above : {cell - stride - 1, cell - stride, cell - stride + 1})
+                {
+                    if (m_parents[above].load(std::memory_order_relaxed) != none)
+                        unite(cell, above);
+                }
+            }
+        });
+
+        // 3. mark the clicked region
+        const uint32_t root = findRoot(start);
+        forEachStrip(strips, [&](uint32_t strip)
+        {
+            for (uint32_t row = firstRow(strip); row < endRow(strip); ++row)
+            {
+                for (uint32_t cell = row * stride + 1, end = cell + width; cell < end; ++cell)
+                    m_inRegion[cell] = m_parents[cell].load(std::memory_order_relaxed) != none && findRoot(cell) == root;
+            }
+        });
+
+        // 4. open the region and every safe tile next to it (each strip only writes its own tiles)
+        forEachStrip(strips, [&](uint32_t strip)
+        {
+            std::vector<uint32_t>& stripOpened = m_opened[strip];
+            stripOpened.clear();
+            for (uint32_t row = firstRow(strip); row < endRow(strip); ++row)
+            {
+                const uint8_t* above = &m_inRegion[(row - 1) * stride];
+                const uint8_t* current = &m_inRegion[row * stride];
+                const uint8_t* below = &m_inRegion[(row + 1) * stride];
+                for (uint32_t col = 1; col <= width; ++col)
+                {
+                    const bool near = above[col - 1] | above[col] | above[col + 1] |
+                                      current[col - 1] | current[col] | current[col + 1] |
+                                      below[col - 1] | below[col] | below[col + 1];
+                    Tile& tile = tiles[row * stride + col];
+                    if (!near || !openable(tile))
+                        continue;
+                    tile.m_state = TileState::notHidden;
+                    stripOpened.push_back((row - 1) * width + col - 1);
+                }
+            }
+        });
+
+        opened.clear();
+        for (const std::vector<uint32_t>& stripOpened : m_opened)
+            opened.insert(opened.end(), stripOpened.begin(), stripOpened.end());
+    }
+};
@@ -0,0 +1,442 @@
+// ProbabilityEstimator.cpp
+#include <ProbabilityEstimator.h>
+#include <Random.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+
+namespace game
+{
+    // The board as it was when start() was called, and the counts sampled from it
+    struct ProbabilityEstimator::Snapshot
+    {
+        // One Markov chain over consistent frontier layouts
+        struct Chain
+        {
+            std::vector<uint8_t> isMine; // per tile (frontier only)
+            std::vector<uint8_t> around; // mines around each number
+            std::vector<uint8_t> undecided; // frontier neighbours of each number not decided yet
+            uint32_t frontierMines = 0;
+
+            // block being resampled and the layouts it can take (mask of mines, mine count)
+            std::vector<uint32_t> block;
+            std::vector<uint8_t> inBlock; // per tile
+            std::vector<std::pair<uint32_t, uint32_t>> layouts;
+            std::vector<double> weights;
+
+            std::vector<uint32_t> counts; // per frontier tile: samples where it was a mine (not added yet)
+            uint64_t interiorMines = 0; // mines left for the interior, summed over samples (not added yet)
+            bool started = false;
+        };
+
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t mines = 0;
+        int32_t offsets[8] = {}; // neighbourSteps in tile indices
+        std::vector<int8_t> number; // per tile: number of an opened tile, -1 if hidden
+        // per tile, bit k for neighbour k (the chains run after start() returns, they can't walk the live board)
+        std::vector<uint8_t> numbersAround; // opened numbers
+        std::vector<uint8_t> frontierAround; // frontier tiles (only filled for numbers)
+        std::vector<uint32_t> frontier; // hidden tiles next to a number (row-major)
+        std::vector<uint32_t> interior; // hidden tiles no number sees
+        // log of the ways to place the remaining mines in the interior, per number of frontier mines
+        std::vector<double> logCompletions;
+
+        std::unique_ptr<std::atomic<uint32_t>[]> mineCounts; // per frontier tile, summed over chains
+        std::atomic<uint64_t> interiorMines {0};
+        std::atomic<uint32_t> samples {0};
+        std::atomic<uint32_t> runningChains {0};
+        std::atomic<bool> cancelled {false};
+
+        // each worker only touches its own generator (no sharing, no false sharing)
+        struct alignas(64) WorkerRandom
+        {
+            Random random;
+        };
+        std::vector<WorkerRandom> random;
+
+        // calls f with the neighbours whose bit is set in around
+        template <typename F>
+        void forEachIn(uint8_t around, uint32_t tileIndex1D, F f) const
+        {
+            for (uint32_t k = 0; k < 8; ++k)
+            {
+                if (around >> k & 1)
+                    f(tileIndex1D + offsets[k]);
+            }
+        }
+
+        template <typename F>
+        void forEachNumber(uint32_t tileIndex1D, F f) const
+        {
+            forEachIn(numbersAround[tileIndex1D], tileIndex1D, f);
+        }
+
+        // bit of neighbour to among the neighbours of from (the first matching step, steps coincide on 1 or 2 wide boards)
+        uint8_t neighbourBit(uint32_t from, uint32_t to) const
+        {
+            uint32_t k = 0;
+            while (int64_t(from) + offsets[k] != int64_t(to))
+                ++k;
+            return uint8_t(1u << k);
+        }
+
+        void decide(Chain& chain, uint32_t tileIndex1D, uint8_t value) const
+        {
+            chain.isMine[tileIndex1D] = value;
+            chain.frontierMines += value;
+            forEachNumber(tileIndex1D, [&](uint32_t n) { --chain.undecided[n]; chain.around[n] += value; });
+        }
+
+        void undo(Chain& chain, uint32_t tileIndex1D) const
+        {
+            const uint8_t value = chain.isMine[tileIndex1D];
+            chain.isMine[tileIndex1D] = 0;
+            chain.frontierMines -= value;
+            forEachNumber(tileIndex1D, [&](uint32_t n) { ++chain.undecided[n]; chain.around[n] -= value; });
+        }
+
+        // numbers around a decided tile can still be satisfied
+        bool fits(const Chain& chain, uint32_t tileIndex1D) const
+        {
+            bool possible = true;
+            forEachNumber(tileIndex1D, [&](uint32_t n)
+            {
+                possible = possible && chain.around[n] <= number[n] && chain.around[n] + chain.undecided[n] >= number[n];
+            });
+            return possible;
+        }
+
+        /**
+         * @brief finds a random frontier layout agreeing with every number and the mine count
+         * (randomized backtracking, the burn-in forgets where it started)
+         *
+         * @return false if no layout was found within maxStartSteps
+         */
+        bool start(Chain& chain, Random& rng) const
+        {
+            const size_t size = number.size();
+            chain.isMine.assign(size, 0);
+            chain.around.assign(size, 0);
+            chain.undecided.assign(size, 0);
+            chain.inBlock.assign(size, 0);
+            chain.frontierMines = 0;
+            for (uint32_t tileIndex1D : frontier)
+                forEachNumber(tileIndex1D, [&](uint32_t n) { ++chain.undecided[n]; });
+
+            std::vector<uint8_t> tried(frontier.size(), 0);
+            std::vector<uint8_t> first(frontier.size(), 0);
+            uint32_t steps = 0;
+            size_t depth = 0;
+            while (depth < frontier.size())
+            {
+                if (++steps > maxStartSteps)
+                    return false;
+                if (tried[depth] == 2)
+                {
+                    // both values failed, change the previous tile
+                    tried[depth] = 0;
+                    if (depth == 0)
+                        return false;
+                    --depth;
+                    undo(chain, frontier[depth]);
+                    continue;
+                }
+                if (tried[depth] == 0)
+                    first[depth] = uint8_t(rng.next() >> 63);
+                const uint8_t value = tried[depth] == 0 ? first[depth] : !first[depth];
+                ++tried[depth];
+                if (chain.frontierMines + value > mines)
+                    continue;
+                decide(chain, frontier[depth], value);
+                // the last tile also has to leave a mine count the interior can hold
+                const bool last = depth + 1 == frontier.size();
+                if (!fits(chain, frontier[depth]) || (last && std::isinf(logCompletions[chain.frontierMines])))
+                {
+                    undo(chain, frontier[depth]);
+                    continue;
+                }
+                ++depth;
+            }
+            chain.counts.assign(frontier.size(), 0);
+            chain.interiorMines = 0;
+            return !std::isinf(logCompletions[chain.frontierMines]);
+        }
+
+        // every layout of chain.block[depth..] agreeing with the numbers (the rest of the board stays)
+        void enumerate(Chain& chain, size_t depth, uint32_t mask, uint32_t blockMines) const
+        {
+            if (depth == chain.block.size())
+            {
+                chain.layouts.emplace_back(mask, blockMines);
+                return;
+            }
+            const uint32_t tileIndex1D = chain.block[depth];
+            for (uint8_t value = 0; value < 2; ++value)
+            {
+                decide(chain, tileIndex1D, value);
+                if (fits(chain, tileIndex1D))
+                    enumerate(chain, depth + 1, mask | (uint32_t(value) << depth), blockMines + value);
+                undo(chain, tileIndex1D);
+            }
+        }
+
+        /**
+         * @brief heat-bath move: a block of frontier tiles linked to a random one gets a new layout,
+         * drawn from every layout agreeing with the numbers, weighted by the interior completions
+         */
+        void step(Chain& chain, Random& rng) const
+        {
+            // breadth-first through shared numbers: the block follows the constraints, even along a long wall
+            // (it only depends on the center, not on the layout)
+            chain.block.assign(1, frontier[rng.bounded(uint32_t(frontier.size()))]);
+            chain.inBlock[chain.block[0]] = 1;
+            for (size_t head = 0; head < chain.block.size() && chain.block.size() < maxBlockSize; ++head)
+            {
+                forEachNumber(chain.block[head], [&](uint32_t n)
+                {
+                    forEachIn(frontierAround[n], n, [&](uint32_t tileIndex1D)
+                    {
+                        if (!chain.inBlock[tileIndex1D] && chain.block.size() < maxBlockSize)
+                        {
+                            chain.inBlock[tileIndex1D] = 1;
+                            chain.block.push_back(tileIndex1D);
+                        }
+                    });
+                });
+            }
+            for (uint32_t tileIndex1D : chain.block)
+                chain.inBlock[tileIndex1D] = 0;
+
+            for (uint32_t tileIndex1D : chain.block)
+                undo(chain, tileIndex1D);
+            chain.layouts.clear();
+            enumerate(chain, 0, 0, 0);
+
+            // the layout the block had is always among them, so the total is never 0
+            // the weight only depends on the mines in the block: one exp per mine count
+            double best = -std::numeric_limits<double>::infinity();
+            for (size_t blockMines = 0; blockMines <= chain.block.size(); ++blockMines)
+                best = std::max(best, logCompletions[chain.frontierMines + blockMines]);
+            double weightOf[maxBlockSize + 1];
+            for (size_t blockMines = 0; blockMines <= chain.block.size(); ++blockMines)
+                weightOf[blockMines] = std::exp(logCompletions[chain.frontierMines + blockMines] - best);
+            chain.weights.resize(chain.layouts.size());
+            double total = 0;
+            for (size_t i = 0; i < chain.layouts.size(); ++i)
+            {
+                total += weightOf[chain.layouts[i].second];
+                chain.weights[i] = total;
+            }
+            const double pick = double(rng.next() >> 11) * (1.0 / double(1ull << 53)) * total;
+            const size_t chosen = std::min(size_t(std::upper_bound(chain.weights.begin(), chain.weights.end(), pick) -
+                                                  chain.weights.begin()), chain.layouts.size() - 1);
+
+            for (size_t i = 0; i < chain.block.size(); ++i)
+                decide(chain, chain.block[i], uint8_t((chain.layouts[chosen].first >> i) & 1));
+        }
+
+        // moves the chain far enough for the next layout to be a new sample
+        void advance(Chain& chain, Random& rng) const
+        {
+            // about every frontier tile gets resampled once
+            for (size_t i = 0; i < frontier.size(); i += maxBlockSize / 2)
+                step(chain, rng);
+        }
+
+        /**
+         * @brief one task: takes samplesPerTask samples, adds them to the shared counts and queues the next task
+         *
+         * @param pool pool running the task
+         * @param self this snapshot (kept alive by the tasks)
+         * @param chain chain continued by the task (nullptr on the first task)
+         */
+        static void sample(ThreadPool& pool, std::shared_ptr<Snapshot> self, std::shared_ptr<Chain> chain)
+        {
+            Snapshot& snapshot = *self;
+            if (snapshot.cancelled.load(std::memory_order_relaxed))
+            {
+                snapshot.runningChains.fetch_sub(1, std::memory_order_relaxed);
+                return;
+            }
+            Random& rng = snapshot.random[pool.currentWorker()].random;
+
+            if (!chain)
+                chain = std::make_shared<Chain>();
+            if (!chain->started)
+            {
+                if (!snapshot.start(*chain, rng))
+                {
+                    snapshot.runningChains.fetch_sub(1, std::memory_order_relaxed);
+                    return;
+                }
+                for (uint32_t i = 0; i < burnInSamples; ++i)
+                    snapshot.advance(*chain, rng);
+                chain->started = true;
+            }
+
+            for (uint32_t i = 0; i < samplesPerTask; ++i)
+            {
+                snapshot.advance(*chain, rng);
+                for (size_t f = 0; f < snapshot.frontier.size(); ++f)
+                    chain->counts[f] += chain->isMine[snapshot.frontier[f]];
+                chain->interiorMines += snapshot.mines - chain->frontierMines;
+            }
+            for (size_t f = 0; f < snapshot.frontier.size(); ++f)
+            {
+                if (chain->counts[f] == 0)
+                    continue;
+                snapshot.mineCounts[f].fetch_add(chain->counts[f], std::memory_order_relaxed);
+                chain->counts[f] = 0;
+            }
+            snapshot.interiorMines.fetch_add(chain->interiorMines, std::memory_order_relaxed);
+            chain->interiorMines = 0;
+            // release: a reader seeing the new sample count sees the counts added before it
+            const uint32_t samples = snapshot.samples.fetch_add(samplesPerTask, std::memory_order_release) + samplesPerTask;
+
+            // without a frontier every sample is the same
+            if (samples >= maxSamples || snapshot.frontier.empty() || snapshot.cancelled.load(std::memory_order_relaxed))
+            {
+                snapshot.runningChains.fetch_sub(1, std::memory_order_relaxed);
+                return;
+            }
+            pool.submit([pool = &pool, self, chain]() { sample(*pool, self, chain); });
+        }
+    };
+
+    /**
+     * @brief
+     *
+     */
+    ProbabilityEstimator::ProbabilityEstimator(ThreadPool& pool)
+        : m_pool(pool)
+    {
+    }
+
+    // cancels the running estimate
+    ProbabilityEstimator::~ProbabilityEstimator()
+    {
+        stop();
+    }
+
+    /**
+     * @brief cancels the previous estimate and starts sampling the board as it is now
+     *
+     */
+    void ProbabilityEstimator::start(const Board& board, uint64_t seed)
+    {
+        stop();
+        m_current.reset();
+        if (board.isFinished() || board.size() == 0)
+            return;
+
+        auto snapshot = std::make_shared<Snapshot>();
+        snapshot->width = board.width();
+        snapshot->height = board.height();
+        snapshot->mines = board.mines();
+        for (uint32_t k = 0; k < 8; ++k)
+            snapshot->offsets[k] = neighbourSteps[k].dy * int32_t(board.width()) + neighbourSteps[k].dx;
+        snapshot->number.assign(board.size(), -1);
+        snapshot->numbersAround.assign(board.size(), 0);
+        snapshot->frontierAround.assign(board.size(), 0);
+        for (uint32_t i = 0; i < board.size(); ++i)
+        {
+            const Tile& tile = board.tile(i);
+            if (tile.m_state == TileState::notHidden && !tile.m_isMine)
+                snapshot->number[i] = int8_t(tile.m_mineCounter);
+        }
+        for (uint32_t i = 0; i < board.size(); ++i)
+        {
+            if (snapshot->number[i] >= 0)
+                continue;
+            board.forEachNeighbour(i, [&](uint32_t n, const Tile&)
+            {
+                if (snapshot->number[n] < 0)
+                    return;
+                snapshot->numbersAround[i] |= snapshot->neighbourBit(i, n);
+                snapshot->frontierAround[n] |= snapshot->neighbourBit(n, i);
+            });
+            (snapshot->numbersAround[i] != 0 ? snapshot->frontier : snapshot->interior).push_back(i);
+        }
+        if (snapshot->frontier.empty() && snapshot->interior.empty())
+            return;
+
+        // C(interior, mines - frontierMines) for every possible frontier mine count
+        const double interior = double(snapshot->interior.size());
+        snapshot->logCompletions.resize(snapshot->frontier.size() + 1);
+        for (size_t frontierMines = 0; frontierMines <= snapshot->frontier.size(); ++frontierMines)
+        {
+            const double rest = double(snapshot->mines) - double(frontierMines);
+            snapshot->logCompletions[frontierMines] = rest < 0 || rest > interior ?
+                -std::numeric_limits<double>::infinity() :
+                std::lgamma(interior + 1) - std::lgamma(rest + 1) - std::lgamma(interior - rest + 1);
+        }
+
+        snapshot->mineCounts.reset(new std::atomic<uint32_t>[snapshot->frontier.size()]);
+        for (size_t f = 0; f < snapshot->frontier.size(); ++f)
+            snapshot->mineCounts[f].store(0, std::memory_order_relaxed);
+        snapshot->random.resize(m_pool.size());
+        for (Snapshot::WorkerRandom& worker : snapshot->random)
+            worker.random = Random(Random::splitmix64(seed));
+
+        // one chain per worker, stealing keeps them all busy (a single one is exact without a frontier)
+        const uint32_t chains = snapshot->frontier.empty() ? 1 : m_pool.size();
+        snapshot->runningChains.store(chains, std::memory_order_relaxed);
+        for (uint32_t i = 0; i < chains; ++i)
+            m_pool.submit([pool = &m_pool, snapshot]() { Snapshot::sample(*pool, snapshot, nullptr); });
+        m_current = snapshot;
+    }
+
+    // cancels the running estimate
+    void ProbabilityEstimator::stop()
+    {
+        if (m_current)
+            m_current->cancelled.store(true, std::memory_order_relaxed);
+    }
+
+    // true while chains are still sampling
+    bool ProbabilityEstimator::isRunning() const
+    {
+        return m_current && !m_current->cancelled.load(std::memory_order_relaxed) &&
+               m_current->runningChains.load(std::memory_order_relaxed) > 0;
+    }
+
+    // layouts sampled so far
+    uint32_t ProbabilityEstimator::samples() const
+    {
+        return m_current ? m_current->samples.load(std::memory_order_acquire) : 0;
+    }
+
+    /**
+     * @brief current estimate (lock-free, can be called while sampling)
+     *
+     */
+    void ProbabilityEstimator::read(std::vector<float>& probabilities) const
+    {
+        if (!m_current)
+        {
+            probabilities.clear();
+            return;
+        }
+        const Snapshot& snapshot = *m_current;
+        probabilities.assign(snapshot.number.size(), -1.f);
+        const uint32_t samples = snapshot.samples.load(std::memory_order_acquire);
+        if (samples == 0)
+            return;
+        // counts of a task still adding can be ahead of the sample count
+        for (size_t f = 0; f < snapshot.frontier.size(); ++f)
+        {
+            const float count = float(snapshot.mineCounts[f].load(std::memory_order_relaxed));
+            probabilities[snapshot.frontier[f]] = std::min(1.f, count / float(samples));
+        }
+        // interior tiles are all alike: mines left for the interior, shared evenly
+        if (!snapshot.interior.empty())
+        {
+            const double interiorMines = double(snapshot.interiorMines.load(std::memory_order_relaxed));
+            const float probability = float(std::min(1.0, interiorMines / (double(samples) * double(snapshot.interior.size()))));
+            for (uint32_t tileIndex1D : snapshot.interior)
+                probabilities[tileIndex1D] = probability;
+        }
+    }
+};
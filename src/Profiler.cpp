@@ -0,0 +1,133 @@
+// Profiler.cpp
+#include <Profiler.h>
+
+#ifdef MINESWEEPER_PROFILER
+
+namespace game
+{
+    Profiler& Profiler::instance()
+    {
+        static Profiler profiler;
+        return profiler;
+    }
+
+    Profiler::Profiler()
+        : m_slots(ringSize), m_startNs(now())
+    {
+        for (History& history : m_history)
+            history.durationsNs.reserve(historySize);
+    }
+
+    /**
+     * @brief moves the samples of the ring to the zone histories and the CSV file
+     *
+     */
+    void Profiler::collect()
+    {
+        const uint64_t head = m_head.load(std::memory_order_acquire);
+        // writers lapped the collector: the oldest samples are gone
+        if (head - m_tail > ringSize)
+        {
+            m_dropped += head - ringSize - m_tail;
+            m_tail = head - ringSize;
+        }
+        for (; m_tail < head; ++m_tail)
+        {
+            const Slot& slot = m_slots[m_tail & (ringSize - 1)];
+            const uint64_t expected = m_tail * 2 + 2;
+            const uint64_t before = slot.sequence.load(std::memory_order_acquire);
+            // still being written, collected next time
+            if (before < expected)
+                break;
+            const uint64_t startNs = slot.startNs.load(std::memory_order_relaxed);
+            const uint32_t durationNs = slot.durationNs.load(std::memory_order_relaxed);
+            const uint32_t frame = slot.frame.load(std::memory_order_relaxed);
+            const uint8_t zone = slot.zone.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            // overwritten by a later ticket (before or while it was read)
+            if (before != expected || slot.sequence.load(std::memory_order_relaxed) != expected ||
+                zone >= uint8_t(ProfileZone::count))
+            {
+                m_dropped++;
+                continue;
+            }
+
+            History& history = m_history[zone];
+            if (history.durationsNs.size() < historySize)
+                history.durationsNs.push_back(durationNs);
+            else
+                history.durationsNs[history.next] = durationNs;
+            history.next = (history.next + 1) % historySize;
+
+            if (m_csv.is_open())
+            {
+                m_csv << frame << ',' << zoneName(ProfileZone(zone)) << ','
+                      << (startNs - std::min(startNs, m_startNs)) << ',' << durationNs << '\n';
+                m_csvSamples++;
+            }
+        }
+    }
+
+    /**
+     * @brief time percentiles of the last historySize samples of a zone
+     *
+     */
+    Profiler::Percentiles Profiler::percentiles(ProfileZone zone) const
+    {
+        Percentiles result;
+        std::vector<uint32_t> durations = m_history[size_t(zone)].durationsNs;
+        if (durations.empty())
+            return result;
+        result.samples = uint32_t(durations.size());
+        auto percentile = [&durations](double p) {
+            const size_t rank = std::min(durations.size() - 1, size_t(p * durations.size()));
+            std::nth_element(durations.begin(), durations.begin() + rank, durations.end());
+            return durations[rank] / 1e6;
+        };
+        result.p50Ms = percentile(0.50);
+        result.p99Ms = percentile(0.99);
+        return result;
+    }
+
+    /**
+     * @brief writes every collected sample to a CSV file from now on
+     *
+     */
+    bool Profiler::openCsv(const std::filesystem::path& path)
+    {
+        // samples recorded before the file was opened are not exported
+        collect();
+        m_csv.close();
+        m_csv.open(path, std::ios::trunc);
+        if (!m_csv)
+            return false;
+        m_csv << "frame,zone,start_ns,duration_ns\n";
+        m_csvSamples = 0;
+        return true;
+    }
+
+    // collects the ring and flushes the CSV file (if one is open)
+    void Profiler::flushCsv()
+    {
+        collect();
+        if (m_csv.is_open())
+            m_csv.flush();
+    }
+
+    const char* Profiler::zoneName(ProfileZone zone)
+    {
+        switch (zone)
+        {
+        case ProfileZone::frame: return "frame";
+        case ProfileZone::events: return "events";
+        case ProfileZone::updateTile: return "updateTile";
+        case ProfileZone::hud: return "hud";
+        case ProfileZone::draw: return "draw";
+        case ProfileZone::display: return "display";
+        case ProfileZone::logic: return "logic";
+        default: return "?";
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,283 @@
+// Recording.cpp
+#include <Recording.h>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+namespace game
+{
+    namespace
+    {
+        const uint8_t magic[4] = {'M', 'S', 'R', 'L'};
+        const uint8_t version = 1;
+        // action type 3 marks the end of the actions (ActionType uses 0..2)
+        const uint64_t endMarker = 3;
+
+        void writeVarint(std::vector<uint8_t>& bytes, uint64_t value)
+        {
+            while (value >= 0x80)
+            {
+                bytes.push_back(uint8_t(value) | 0x80);
+                value >>= 7;
+            }
+            bytes.push_back(uint8_t(value));
+        }
+
+        void writeFixed64(std::vector<uint8_t>& bytes, uint64_t value)
+        {
+            for (int i = 0; i < 8; ++i)
+                bytes.push_back(uint8_t(value >> (8 * i)));
+        }
+
+        // small negative deltas become small numbers too
+        uint64_t zigzag(int64_t value)
+        {
+            return (uint64_t(value) << 1) ^ uint64_t(value >> 63);
+        }
+
+        int64_t unzigzag(uint64_t value)
+        {
+            return int64_t(value >> 1) ^ -int64_t(value & 1);
+        }
+
+        // reads from a byte range, fails (instead of reading past the end) on truncated data
+        struct Reader
+        {
+            const uint8_t* data;
+            size_t size;
+            size_t offset = 0;
+
+            bool varint(uint64_t& value)
+            {
+                value = 0;
+                for (int shift = 0; shift < 64; shift += 7)
+                {
+                    if (offset == size)
+                        return false;
+                    const uint8_t byte = data[offset++];
+                    value |= uint64_t(byte & 0x7f) << shift;
+                    if ((byte & 0x80) == 0)
+                        return true;
+                }
+                return false;
+            }
+
+            bool varint32(uint32_t& value)
+            {
+                uint64_t wide;
+                if (!varint(wide) || wide > UINT32_MAX)
+                    return false;
+                value = uint32_t(wide);
+                return true;
+            }
+
+            bool fixed64(uint64_t& value)
+            {
+                if (size - offset < 8)
+                    return false;
+                value = 0;
+                for (int i = 0; i < 8; ++i)
+                    value |= uint64_t(data[offset++]) << (8 * i);
+                return true;
+            }
+        };
+    }
+
+    // Default Constructor (You have to call start to begin a recording)
+    Recorder::Recorder()
+    {
+
+    }
+
+    /**
+     * @brief drops the previous recording and writes the header
+     *
+     */
+    void Recorder::start(const RecordingHeader& header)
+    {
+        m_bytes.assign(std::begin(magic), std::end(magic));
+        m_bytes.push_back(version);
+        writeVarint(m_bytes, header.width);
+        writeVarint(m_bytes, header.height);
+        writeVarint(m_bytes, header.mines);
+        writeVarint(m_bytes, header.safeRadius);
+        m_seedOffset = m_bytes.size();
+        writeFixed64(m_bytes, header.seed);
+        m_lastTimeMs = 0;
+        m_lastTile = 0;
+        m_finished = false;
+    }
+
+    // sets the generation seed
+    void Recorder::setSeed(uint64_t seed)
+    {
+        for (int i = 0; i < 8; ++i)
+            m_bytes[m_seedOffset + i] = uint8_t(seed >> (8 * i));
+    }
+
+    /**
+     * @brief appends one action
+     *
+     */
+    void Recorder::record(const Action& action, uint32_t timeMs)
+    {
+        if (m_finished)
+            return;
+        // clock never goes back, but don't trust it
+        const uint32_t timeDelta = timeMs >= m_lastTimeMs ? timeMs - m_lastTimeMs : 0;
+        writeVarint(m_bytes, (uint64_t(timeDelta) << 2) | uint64_t(action.type));
+        writeVarint(m_bytes, zigzag(int64_t(action.tileIndex1D) - int64_t(m_lastTile)));
+        m_lastTimeMs += timeDelta;
+        m_lastTile = action.tileIndex1D;
+    }
+
+    /**
+     * @brief appends the end marker and the final state of the board
+     *
+     */
+    void Recorder::finish(const Board& board)
+    {
+        if (m_finished)
+            return;
+        writeVarint(m_bytes, endMarker);
+        m_bytes.push_back(uint8_t(board.status()));
+        writeFixed64(m_bytes, boardStateHash(board));
+        m_finished = true;
+    }
+
+    /**
+     * @brief writes the recording to a file
+     *
+     */
+    bool Recorder::save(const std::filesystem::path& path) const
+    {
+        std::ofstream file(path, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(m_bytes.data()), std::streamsize(m_bytes.size()));
+        return bool(file);
+    }
+
+    /**
+     * @brief hash of the state a replay must reproduce
+     *
+     */
+    uint64_t boardStateHash(const Board& board)
+    {
+        uint64_t hash = 0xcbf29ce484222325ull;
+        auto mix = [&hash](uint64_t value)
+        {
+            hash ^= value;
+            hash *= 0x100000001b3ull;
+        };
+
+        mix(uint64_t(board.status()));
+        mix(board.revealedSafe());
+        mix(board.correctFlags());
+        mix(board.wrongFlags());
+        for (uint32_t i = 0; i < board.size(); ++i)
+        {
+            const Tile& tile = board.tile(i);
+            if (tile.m_isMine)
+                continue;
+            // peeking is only drawn, a peeked tile is a hidden one
+            const TileState state = tile.m_state == TileState::peek ? TileState::hidden : tile.m_state;
+            mix(uint64_t(state));
+        }
+        return hash;
+    }
+
+    /**
+     * @brief parses a recording
+     *
+     */
+    bool parseRecording(const uint8_t* data, size_t size, Recording& recording)
+    {
+        Reader reader {data, size};
+        if (size < sizeof(magic) + 1 || !std::equal(std::begin(magic), std::end(magic), data) ||
+            data[sizeof(magic)] != version)
+            return false;
+        reader.offset = sizeof(magic) + 1;
+
+        RecordingHeader& header = recording.header;
+        if (!reader.varint32(header.width) || !reader.varint32(header.height) ||
+            !reader.varint32(header.mines) || !reader.varint32(header.safeRadius) ||
+            !reader.fixed64(header.seed))
+            return false;
+        if (!Board::fits(header.width, header.height))
+            return false;
+        const uint64_t size1D = uint64_t(header.width) * header.height;
+
+        recording.actions.clear();
+        recording.hasFinalState = false;
+        uint32_t timeMs = 0;
+        int64_t tile = 0;
+        while (reader.offset < size)
+        {
+            uint64_t tag;
+            if (!reader.varint(tag))
+                return false;
+            if (tag == endMarker)
+            {
+                uint64_t hash;
+                if (reader.offset == size || data[reader.offset] > uint8_t(GameStatus::lost))
+                    return false;
+                recording.finalStatus = GameStatus(data[reader.offset++]);
+                if (!reader.fixed64(hash))
+                    return false;
+                recording.finalHash = hash;
+                recording.hasFinalState = true;
+                return reader.offset == size;
+            }
+
+            uint64_t delta;
+            if ((tag & 3) == endMarker || !reader.varint(delta))
+                return false;
+            timeMs += uint32_t(tag >> 2);
+            tile += unzigzag(delta);
+            if (tile < 0 || uint64_t(tile) >= size1D)
+                return false;
+            recording.actions.push_back({{ActionType(tag & 3), uint32_t(tile)}, timeMs});
+        }
+        // recording without end marker (game was not finished), still replayable
+        return true;
+    }
+
+    /**
+     * @brief reads and parses a recording file
+     *
+     */
+    bool loadRecording(const std::filesystem::path& path, Recording& recording)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+            return false;
+        const std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        return parseRecording(bytes.data(), bytes.size(), recording);
+    }
+
+    /**
+     * @brief plays a recording again as fast as possible
+     *
+     */
+    ReplayResult replay(const Recording& recording, Board& board)
+    {
+        const RecordingHeader& header = recording.header;
+        board.reset(header.width, header.height, header.mines);
+
+        ReplayResult result;
+        for (const RecordedAction& recorded : recording.actions)
+        {
+            // first click generates the level (like Game does)
+            if (board.status() == GameStatus::notStarted && recorded.action.type == ActionType::reveal)
+                board.generate(recorded.action.tileIndex1D, header.seed, header.safeRadius);
+            apply(board, recorded.action);
+            result.actions++;
+        }
+        board.clearChanges();
+
+        result.status = board.status();
+        result.hash = boardStateHash(board);
+        result.matched = !recording.hasFinalState ||
+                         (result.status == recording.finalStatus && result.hash == recording.finalHash);
+        return result;
+    }
+};
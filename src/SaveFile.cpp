@@ -0,0 +1,344 @@
+// SaveFile.cpp
+#include <SaveFile.h>
+#include <algorithm>
+#include <cstring>
+
+#ifdef _WIN32
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
+
+namespace game
+{
+    namespace
+    {
+        // little-endian, whatever the host
+        void writeUnsigned(uint8_t* bytes, uint64_t value, uint32_t size)
+        {
+            for (uint32_t i = 0; i < size; ++i)
+                bytes[i] = uint8_t(value >> (8 * i));
+        }
+
+        uint64_t readUnsigned(const uint8_t* bytes, uint32_t size)
+        {
+            uint64_t value = 0;
+            for (uint32_t i = 0; i < size; ++i)
+                value |= uint64_t(bytes[i]) << (8 * i);
+            return value;
+        }
+
+        // SaveHeader as it is on disk (same bytes on any host, the rest is zeros)
+        void encodeHeader(const SaveHeader& header, uint8_t* bytes)
+        {
+            std::fill(bytes, bytes + saveHeaderBytes, uint8_t(0));
+            std::copy(header.magic, header.magic + 4, bytes);
+            writeUnsigned(bytes + 4, header.version, 4);
+            writeUnsigned(bytes + 8, header.headerSize, 4);
+            writeUnsigned(bytes + 12, header.width, 4);
+            writeUnsigned(bytes + 16, header.height, 4);
+            writeUnsigned(bytes + 20, header.mines, 4);
+            writeUnsigned(bytes + 24, header.seed, 8);
+            writeUnsigned(bytes + 32, header.elapsedMs, 4);
+            bytes[36] = header.status;
+        }
+
+        SaveHeader decodeHeader(const uint8_t* bytes)
+        {
+            SaveHeader header;
+            std::copy(bytes, bytes + 4, header.magic);
+            header.version = uint32_t(readUnsigned(bytes + 4, 4));
+            header.headerSize = uint32_t(readUnsigned(bytes + 8, 4));
+            header.width = uint32_t(readUnsigned(bytes + 12, 4));
+            header.height = uint32_t(readUnsigned(bytes + 16, 4));
+            header.mines = uint32_t(readUnsigned(bytes + 20, 4));
+            header.seed = readUnsigned(bytes + 24, 8);
+            header.elapsedMs = uint32_t(readUnsigned(bytes + 32, 4));
+            header.status = bytes[36];
+            return header;
+        }
+    }
+
+    // Default Constructor (You have to call create or open)
+    SaveFile::SaveFile()
+    {
+#ifdef _WIN32
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        m_pageSize = info.dwAllocationGranularity;
+#else
+        m_pageSize = size_t(sysconf(_SC_PAGESIZE));
+#endif
+    }
+
+    SaveFile::~SaveFile()
+    {
+        close();
+    }
+
+    /**
+     * @brief creates (or overwrites) a save file holding the board
+     *
+     */
+    bool SaveFile::create(const std::filesystem::path& path, const Board& board, uint64_t seed)
+    {
+        close();
+        if (!map(path, saveHeaderBytes + board.size(), true))
+            return false;
+
+        m_header = SaveHeader();
+        m_header.width = board.width();
+        m_header.height = board.height();
+        m_header.mines = board.mines();
+        m_header.seed = seed;
+        store(board);
+        return true;
+    }
+
+    /**
+     * @brief maps an existing save file (only the header is read)
+     *
+     */
+    bool SaveFile::open(const std::filesystem::path& path)
+    {
+        close();
+        std::error_code error;
+        const uintmax_t fileSize = std::filesystem::file_size(path, error);
+        if (error || fileSize < saveHeaderBytes || !map(path, size_t(fileSize), false))
+            return false;
+
+        const SaveHeader saved = decodeHeader(m_data);
+        const SaveHeader expected;
+        const bool valid = std::memcmp(saved.magic, expected.magic, sizeof(saved.magic)) == 0 &&
+                           saved.version == expected.version && saved.headerSize == expected.headerSize &&
+                           saved.status <= uint8_t(GameStatus::lost) && Board::fits(saved.width, saved.height) &&
+                           saved.mines < uint64_t(saved.width) * saved.height &&
+                           fileSize == saveHeaderBytes + uint64_t(saved.width) * saved.height;
+        if (!valid)
+            close();
+        m_header = valid ? saved : SaveHeader();
+        return valid;
+    }
+
+    /**
+     * @brief rebuilds the saved board (reads every tile)
+     *
+     */
+    bool SaveFile::restore(Board& board) const
+    {
+        return board.restore(m_header.width, m_header.height, m_header.mines, GameStatus(m_header.status), m_data + saveHeaderBytes);
+    }
+
+    /**
+     * @brief writes every tile
+     *
+     */
+    void SaveFile::store(const Board& board)
+    {
+        uint8_t* packed = tiles();
+        for (uint32_t i = 0; i < board.size(); ++i)
+        {
+            Tile tile = board.tile(i);
+            // peeking is only drawn
+            if (tile.m_state == TileState::peek)
+                tile.m_state = TileState::hidden;
+            packed[i] = tile.pack();
+        }
+        m_header.status = uint8_t(board.status());
+        writeHeader();
+        std::lock_guard<std::mutex> lock(m_dirtyMutex);
+        markDirty(0, m_size);
+    }
+
+    /**
+     * @brief writes changed tiles and the header to the mapping and marks their pages dirty
+     *
+     */
+    void SaveFile::update(const Board& board, const std::vector<uint32_t>& changedTiles, uint32_t elapsedMs)
+    {
+        if (!isOpen())
+            return;
+        uint8_t* packed = tiles();
+        std::lock_guard<std::mutex> lock(m_dirtyMutex);
+        for (uint32_t tileIndex1D : changedTiles)
+        {
+            Tile tile = board.tile(tileIndex1D);
+            if (tile.m_state == TileState::peek)
+                tile.m_state = TileState::hidden;
+            packed[tileIndex1D] = tile.pack();
+            markDirty(saveHeaderBytes + tileIndex1D, 1);
+        }
+        m_header.status = uint8_t(board.status());
+        m_header.elapsedMs = elapsedMs;
+        writeHeader();
+        markDirty(0, saveHeaderBytes);
+    }
+
+    /**
+     * @brief flushes dirty pages on a background thread every interval
+     *
+     */
+    void SaveFile::startAutosave(std::chrono::milliseconds interval)
+    {
+        stopAutosave();
+        m_stopAutosave = false;
+        m_autosave = std::thread([this, interval]()
+        {
+            std::unique_lock<std::mutex> lock(m_dirtyMutex);
+            while (!m_stopAutosave)
+            {
+                m_wakeUp.wait_for(lock, interval, [this]() { return m_stopAutosave; });
+                // take the dirty list, flush without holding the lock
+                std::vector<size_t> pages;
+                pages.swap(m_dirtyPages);
+                for (size_t page : pages)
+                    m_isDirty[page] = false;
+                lock.unlock();
+                flushPages(pages);
+                lock.lock();
+            }
+        });
+    }
+
+    // stops the autosave thread (after a last flush)
+    void SaveFile::stopAutosave()
+    {
+        if (!m_autosave.joinable())
+            return;
+        {
+            std::lock_guard<std::mutex> lock(m_dirtyMutex);
+            m_stopAutosave = true;
+        }
+        m_wakeUp.notify_one();
+        m_autosave.join();
+    }
+
+    // writes dirty pages to disk now
+    void SaveFile::flush()
+    {
+        std::vector<size_t> pages;
+        {
+            std::lock_guard<std::mutex> lock(m_dirtyMutex);
+            pages.swap(m_dirtyPages);
+            for (size_t page : pages)
+                m_isDirty[page] = false;
+        }
+        flushPages(pages);
+    }
+
+    // flushes and unmaps the file
+    void SaveFile::close()
+    {
+        stopAutosave();
+        if (!isOpen())
+            return;
+        flush();
+#ifdef _WIN32
+        UnmapViewOfFile(m_data);
+        CloseHandle(m_mapping);
+        CloseHandle(m_file);
+        m_mapping = m_file = nullptr;
+#else
+        munmap(m_data, m_size);
+        ::close(m_fd);
+        m_fd = -1;
+#endif
+        m_data = nullptr;
+        m_size = 0;
+        m_header = SaveHeader();
+        m_isDirty.clear();
+        m_dirtyPages.clear();
+    }
+
+    /**
+     * @brief maps a file read/write
+     *
+     */
+    bool SaveFile::map(const std::filesystem::path& path, size_t size, bool create)
+    {
+#ifdef _WIN32
+        m_file = CreateFileW(path.wstring().c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr,
+                             create ? CREATE_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (m_file == INVALID_HANDLE_VALUE)
+        {
+            m_file = nullptr;
+            return false;
+        }
+        // mapping a size bigger than the file grows it
+        m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_READWRITE, DWORD(uint64_t(size) >> 32), DWORD(size), nullptr);
+        void* data = m_mapping ? MapViewOfFile(m_mapping, FILE_MAP_ALL_ACCESS, 0, 0, size) : nullptr;
+        if (data == nullptr)
+        {
+            if (m_mapping)
+                CloseHandle(m_mapping);
+            CloseHandle(m_file);
+            m_mapping = m_file = nullptr;
+            return false;
+        }
+#else
+        m_fd = ::open(path.c_str(), O_RDWR | (create ? O_CREAT | O_TRUNC : 0), 0644);
+        if (m_fd < 0)
+            return false;
+        void* data = MAP_FAILED;
+        if (!create || ftruncate(m_fd, off_t(size)) == 0)
+            data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+        if (data == MAP_FAILED)
+        {
+            ::close(m_fd);
+            m_fd = -1;
+            return false;
+        }
+#endif
+        m_data = static_cast<uint8_t*>(data);
+        m_size = size;
+        m_isDirty.assign((size + m_pageSize - 1) / m_pageSize, false);
+        m_dirtyPages.clear();
+        return true;
+    }
+
+    // writes m_header to the mapping
+    void SaveFile::writeHeader()
+    {
+        encodeHeader(m_header, m_data);
+    }
+
+    // marks the pages of a byte range dirty (m_dirtyMutex must be locked)
+    void SaveFile::markDirty(size_t offset, size_t length)
+    {
+        const size_t last = (offset + length - 1) / m_pageSize;
+        for (size_t page = offset / m_pageSize; page <= last; ++page)
+        {
+            if (m_isDirty[page])
+                continue;
+            m_isDirty[page] = true;
+            m_dirtyPages.push_back(page);
+        }
+    }
+
+    // flushes the given pages, merging neighbour pages
+    void SaveFile::flushPages(std::vector<size_t>& pages)
+    {
+        std::sort(pages.begin(), pages.end());
+        for (size_t i = 0; i < pages.size();)
+        {
+            size_t end = i + 1;
+            while (end < pages.size() && pages[end] == pages[end - 1] + 1)
+                ++end;
+            const size_t offset = pages[i] * m_pageSize;
+            const size_t length = std::min(m_size, pages[end - 1] * m_pageSize + m_pageSize) - offset;
+#ifdef _WIN32
+            FlushViewOfFile(m_data + offset, length);
+#else
+            msync(m_data + offset, length, MS_SYNC);
+#endif
+            i = end;
+        }
+#ifdef _WIN32
+        if (!pages.empty())
+            FlushFileBuffers(m_file);
+#endif
+    }
+};
@@ -0,0 +1,249 @@
+// SharedBoard.cpp
+#include <SharedBoard.h>
+#include <algorithm>
+
+namespace game
+{
+    namespace
+    {
+        uint32_t makeWord(uint32_t version, TileState state)
+        {
+            return version << 8 | uint32_t(uint8_t(state));
+        }
+
+        TileState stateOf(uint32_t word)
+        {
+            return TileState(uint8_t(word & 0xff));
+        }
+    }
+
+    SharedBoard::SharedBoard(uint32_t width, uint32_t height, uint32_t mines, uint64_t seed, uint32_t safeRadius)
+        : m_stride(width + 2), m_width(width), m_height(height), m_seed(seed), m_safeRadius(safeRadius)
+    {
+        // first clicked tile is never a mine
+        m_mines = std::min<uint32_t>(mines, size() - 1);
+        const size_t paddedSize = size_t(m_stride) * (height + 2);
+        m_tiles.assign(paddedSize, Tile());
+        m_words.reset(new std::atomic<uint32_t>[paddedSize]);
+        for (size_t i = 0; i < paddedSize; ++i)
+            m_words[i].store(makeWord(0, TileState::sentinel), std::memory_order_relaxed);
+        for (uint32_t row = 1; row <= height; ++row)
+        {
+            for (uint32_t col = 1; col <= width; ++col)
+                m_words[row * m_stride + col].store(makeWord(0, TileState::hidden), std::memory_order_relaxed);
+        }
+        for (uint32_t k = 0; k < 8; ++k)
+        {
+            m_paddedOffsets[k] = neighbourSteps[k].dy * int32_t(m_stride) + neighbourSteps[k].dx;
+            m_offsets[k] = neighbourSteps[k].dy * int32_t(width) + neighbourSteps[k].dx;
+        }
+    }
+
+    /**
+     * @brief generates the level around the first revealed tile
+     *
+     */
+    void SharedBoard::start(uint32_t firstClick)
+    {
+        // same level as a Board with the same seed and first click (clients generate it too)
+        Board board(m_width, m_height, m_mines);
+        board.setHeadless(true);
+        board.generate(firstClick, m_seed, m_safeRadius);
+        for (uint32_t row = 0; row < m_height; ++row)
+        {
+            Tile* tiles = &m_tiles[(row + 1) * m_stride + 1];
+            board.forEachInRow(row, [tiles](uint32_t col, const Tile& tile) { tiles[col] = tile; });
+        }
+        m_firstClick = firstClick;
+        // publishes the tiles above to the threads that see the game playing
+        m_status.store(GameStatus::playing, std::memory_order_release);
+    }
+
+    /**
+     * @brief opens a tile, opening its empty neighbours too
+     *
+     */
+    bool SharedBoard::reveal(uint32_t tileIndex1D, std::vector<TileChange>& changes)
+    {
+        if (tileIndex1D >= size())
+            return false;
+        std::call_once(m_started, [this, tileIndex1D]() { start(tileIndex1D); });
+        if (status() != GameStatus::playing)
+            return false;
+
+        const uint32_t padded = paddedIndex(tileIndex1D);
+        // players open a mine -> they lose
+        if (m_tiles[padded].m_isMine)
+        {
+            const uint32_t word = m_words[padded].load(std::memory_order_acquire);
+            if (stateOf(word) != TileState::hidden ||
+                !changeState(tileIndex1D, padded, word, TileState::mineClicked, changes))
+                return false;
+            endGame(false);
+            return true;
+        }
+
+        const size_t queueHead = changes.size();
+        if (!openTile(tileIndex1D, padded, changes))
+            return false;
+        unhideEmptyNeighbours(queueHead, changes);
+        return true;
+    }
+
+    /**
+     * @brief sets/unsets a flag on a hidden tile
+     *
+     */
+    bool SharedBoard::toggleFlag(uint32_t tileIndex1D, std::vector<TileChange>& changes)
+    {
+        if (tileIndex1D >= size() || status() != GameStatus::playing)
+            return false;
+
+        const uint32_t padded = paddedIndex(tileIndex1D);
+        const bool isMine = m_tiles[padded].m_isMine;
+        const uint32_t word = m_words[padded].load(std::memory_order_acquire);
+        // a wrapped version would be older than every earlier change for the clients
+        if ((word >> 8) + 1 >= maxVersion)
+            return false;
+        if (stateOf(word) == TileState::flagged)
+        {
+            if (!changeState(tileIndex1D, padded, word, TileState::hidden, changes))
+                return false;
+            m_flags.fetch_sub(1, std::memory_order_relaxed);
+            (isMine ? m_correctFlags : m_wrongFlags).fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+        if (stateOf(word) != TileState::hidden || !changeState(tileIndex1D, padded, word, TileState::flagged, changes))
+            return false;
+        (isMine ? m_correctFlags : m_wrongFlags).fetch_add(1, std::memory_order_relaxed);
+        // if players use all their flags - endGame (win only if all flags are on mines)
+        if (m_flags.fetch_add(1, std::memory_order_acq_rel) + 1 == m_mines)
+            endGame(m_wrongFlags.load(std::memory_order_relaxed) == 0);
+        return true;
+    }
+
+    /**
+     * @brief opens all non-flagged neighbours if number of flagged neighbours >= number of tile
+     *
+     */
+    bool SharedBoard::chord(uint32_t tileIndex1D, std::vector<TileChange>& changes)
+    {
+        if (tileIndex1D >= size() || status() != GameStatus::playing)
+            return false;
+        const uint32_t padded = paddedIndex(tileIndex1D);
+        if (stateOf(m_words[padded].load(std::memory_order_acquire)) != TileState::notHidden)
+            return false;
+
+        // flags may move while counting, the action sees the board of some moment like a click would
+        uint32_t flagCounter = 0;
+        bool flagNotOnMine = false;
+        for (int32_t offset : m_paddedOffsets)
+        {
+            if (stateOf(m_words[padded + offset].load(std::memory_order_acquire)) == TileState::flagged)
+            {
+                flagCounter++;
+                if (!m_tiles[padded + offset].m_isMine)
+                    flagNotOnMine = true;
+            }
+        }
+        // not enough flags, player is just peeking
+        if (flagCounter < uint32_t(m_tiles[padded].m_mineCounter))
+            return false;
+        // a flag was on a wrong tile -> players lose
+        if (flagNotOnMine)
+        {
+            endGame(false);
+            return true;
+        }
+
+        const size_t queueHead = changes.size();
+        for (uint32_t k = 0; k < 8; ++k)
+        {
+            if (!m_tiles[padded + m_paddedOffsets[k]].m_isMine)
+                openTile(tileIndex1D + m_offsets[k], padded + m_paddedOffsets[k], changes);
+        }
+        unhideEmptyNeighbours(queueHead, changes);
+        return true;
+    }
+
+    /**
+     * @brief state of every tile that changed since the game started
+     *
+     */
+    void SharedBoard::snapshot(std::vector<TileChange>& tiles) const
+    {
+        tiles.clear();
+        for (uint32_t row = 0; row < m_height; ++row)
+        {
+            for (uint32_t col = 0; col < m_width; ++col)
+            {
+                const uint32_t word = m_words[(row + 1) * m_stride + col + 1].load(std::memory_order_acquire);
+                if (word >> 8 != 0)
+                    tiles.push_back({row * m_width + col, word >> 8, stateOf(word)});
+            }
+        }
+    }
+
+    /**
+     * @brief changes a tile from one state to another
+     *
+     */
+    bool SharedBoard::changeState(uint32_t tileIndex1D, uint32_t padded, uint32_t word, TileState state,
+                                  std::vector<TileChange>& changes)
+    {
+        const uint32_t version = (word >> 8) + 1;
+        if (version > maxVersion || !m_words[padded].compare_exchange_strong(word, makeWord(version, state), std::memory_order_acq_rel))
+            return false;
+        changes.push_back({tileIndex1D, version, state});
+        return true;
+    }
+
+    /**
+     * @brief opens a hidden non-mined tile if no other thread did
+     *
+     */
+    bool SharedBoard::openTile(uint32_t tileIndex1D, uint32_t padded, std::vector<TileChange>& changes)
+    {
+        uint32_t word = m_words[padded].load(std::memory_order_acquire);
+        // a flag put meanwhile keeps the tile closed, an opening thread wins the tile
+        while (stateOf(word) == TileState::hidden)
+        {
+            if (changeState(tileIndex1D, padded, word, TileState::notHidden, changes))
+            {
+                // every safe tile is open -> players win without flagging
+                if (m_revealedSafe.fetch_add(1, std::memory_order_acq_rel) + 1 == size() - m_mines)
+                    endGame(true);
+                return true;
+            }
+            word = m_words[padded].load(std::memory_order_acquire);
+        }
+        return false;
+    }
+
+    /**
+     * @brief opens hidden neighbours of every empty tile opened from changes[queueHead] on
+     *
+     */
+    void SharedBoard::unhideEmptyNeighbours(size_t queueHead, std::vector<TileChange>& changes)
+    {
+        // changes is the queue: every tile this call opened is appended once (breadth first)
+        for (; queueHead < changes.size(); ++queueHead)
+        {
+            const uint32_t tileIndex1D = changes[queueHead].tileIndex1D;
+            const uint32_t padded = paddedIndex(tileIndex1D);
+            if (m_tiles[padded].m_mineCounter != 0)
+                continue;
+            // neighbours of an empty tile are never mines, sentinels are never hidden
+            for (uint32_t k = 0; k < 8; ++k)
+                openTile(tileIndex1D + m_offsets[k], padded + m_paddedOffsets[k], changes);
+        }
+    }
+
+    // first call decides how the game ends
+    void SharedBoard::endGame(bool userWon)
+    {
+        GameStatus playing = GameStatus::playing;
+        m_status.compare_exchange_strong(playing, userWon ? GameStatus::won : GameStatus::lost,
+                                         std::memory_order_acq_rel);
+    }
+};
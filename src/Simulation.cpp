@@ -0,0 +1,82 @@
+// Simulation.cpp
+#include <Simulation.h>
+#include <Random.h>
+
+namespace game
+{
+    /**
+     * @brief applies one action on a board
+     *
+     */
+    bool apply(Board& board, const Action& action)
+    {
+        switch (action.type)
+        {
+        case ActionType::reveal:
+            return board.reveal(action.tileIndex1D);
+        case ActionType::flag:
+            return board.toggleFlag(action.tileIndex1D);
+        case ActionType::chord:
+            return board.chord(action.tileIndex1D);
+        }
+        return false;
+    }
+
+    /**
+     * @brief plays config.games games on one thread, reusing one board
+     *
+     */
+    SimulationResult simulate(const SimulationConfig& config)
+    {
+        SimulationResult result;
+        if (config.script.empty())
+            return result;
+
+        Board board;
+        board.setHeadless(true);
+        const uint32_t firstClick = config.script.front().tileIndex1D;
+
+        for (uint64_t game = 0; game < config.games; ++game)
+        {
+            board.reset(config.width, config.height, config.mines);
+            board.generate(firstClick, config.seed + game, config.safeRadius);
+
+            for (const Action& action : config.script)
+            {
+                if (board.isFinished())
+                    break;
+                apply(board, action);
+                result.actions++;
+            }
+
+            if (board.status() == GameStatus::won)
+                result.won++;
+            else if (board.status() == GameStatus::lost)
+                result.lost++;
+            else
+                result.unfinished++;
+        }
+        result.games = config.games;
+        return result;
+    }
+
+    /**
+     * @brief builds a script of random reveals (plus a chord after each one)
+     *
+     */
+    std::vector<Action> randomScript(uint32_t width, uint32_t height, uint32_t length, uint64_t seed)
+    {
+        Random random(seed);
+        const uint32_t size = width * height;
+
+        std::vector<Action> script;
+        script.reserve(length * 2);
+        for (uint32_t i = 0; i < length; ++i)
+        {
+            const uint32_t tileIndex1D = random.bounded(size);
+            script.push_back({ActionType::reveal, tileIndex1D});
+            script.push_back({ActionType::chord, tileIndex1D});
+        }
+        return script;
+    }
+};
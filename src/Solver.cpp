@@ -0,0 +1,392 @@
+// Solver.cpp
+#include <Solver.h>
+#include <algorithm>
+
+namespace game
+{
+    namespace
+    {
+        // one number of a frontier component during enumeration
+        struct Constraint
+        {
+            int remaining = 0; // mines still missing around the number
+            uint32_t unassigned = 0; // unknown neighbours not assigned yet
+            int mines = 0; // unknown neighbours assigned as mine
+        };
+
+        // backtracking over the tiles of a component
+        struct Enumeration
+        {
+            std::vector<Constraint> constraints;
+            std::vector<std::vector<uint32_t>> constraintsOf; // variable -> its constraints
+            std::vector<bool> assignment;
+            std::vector<uint64_t> mineSolutions; // variable -> solutions where it's a mine
+            uint64_t solutions = 0;
+            uint32_t steps = 0;
+            bool aborted = false;
+
+            void run(uint32_t variable)
+            {
+                if (aborted || ++steps > Solver::maxEnumerationSteps)
+                {
+                    aborted = true;
+                    return;
+                }
+                if (variable == assignment.size())
+                {
+                    solutions++;
+                    for (uint32_t i = 0; i < assignment.size(); ++i)
+                        mineSolutions[i] += assignment[i];
+                    return;
+                }
+                for (int isMine = 0; isMine < 2; ++isMine)
+                {
+                    // assign and check every constraint of the variable can still be met
+                    bool possible = true;
+                    for (uint32_t c : constraintsOf[variable])
+                    {
+                        Constraint& constraint = constraints[c];
+                        constraint.unassigned--;
+                        constraint.mines += isMine;
+                        if (constraint.mines > constraint.remaining ||
+                            constraint.mines + int(constraint.unassigned) < constraint.remaining)
+                            possible = false;
+                    }
+                    if (possible)
+                    {
+                        assignment[variable] = isMine;
+                        run(variable + 1);
+                    }
+                    for (uint32_t c : constraintsOf[variable])
+                    {
+                        constraints[c].unassigned++;
+                        constraints[c].mines -= isMine;
+                    }
+                }
+            }
+        };
+    }
+
+    // Default Constructor (You have to call reset to attach a board)
+    Solver::Solver()
+    {
+
+    }
+
+    /**
+     * @brief attaches to a board and forgets all deductions
+     *
+     */
+    void Solver::reset(const Board& board)
+    {
+        m_board = &board;
+        const uint32_t size = board.size();
+        m_known.assign(size, Knowledge::unknown);
+        m_queue.clear();
+        m_queued.assign(size, false);
+        m_dirty.clear();
+        m_isDirty.assign(size, false);
+        m_safe.clear();
+        m_mines.clear();
+        m_variable.assign(size, -1);
+        m_inComponent.assign(size, false);
+
+        // board may already be played
+        std::vector<uint32_t> opened;
+        for (uint32_t i = 0; i < size; ++i)
+            if (isOpened(i))
+                opened.push_back(i);
+        update(opened);
+    }
+
+    /**
+     * @brief re-examines numbers around changed tiles
+     *
+     */
+    void Solver::update(const std::vector<uint32_t>& changedTiles)
+    {
+        if (m_board == nullptr || m_board->isFinished())
+            return;
+
+        for (uint32_t tileIndex1D : changedTiles)
+        {
+            // flags/peeks are not evidence, only opened tiles are
+            if (!isOpened(tileIndex1D))
+                continue;
+            m_known[tileIndex1D] = Knowledge::safe;
+            // the new number and the numbers around it (one unknown less)
+            enqueue(tileIndex1D);
+            enqueueNeighbours(tileIndex1D);
+        }
+
+        // propagate cheap rules first, enumerate only when they are stuck
+        do
+        {
+            while (!m_queue.empty())
+            {
+                const uint32_t tileIndex1D = m_queue.back();
+                m_queue.pop_back();
+                m_queued[tileIndex1D] = false;
+                examine(tileIndex1D);
+            }
+            enumerateDirtyComponents();
+        } while (!m_queue.empty());
+    }
+
+    /**
+     * @brief next deduction that is still useful
+     *
+     */
+    bool Solver::hint(Hint& hint)
+    {
+        // drop deductions the player already used
+        while (!m_safe.empty() && m_board->tile(m_safe.back()).m_state == TileState::notHidden)
+            m_safe.pop_back();
+        if (!m_safe.empty())
+        {
+            hint = {m_safe.back(), false};
+            return true;
+        }
+        while (!m_mines.empty() && m_board->tile(m_mines.back()).m_state == TileState::flagged)
+            m_mines.pop_back();
+        if (!m_mines.empty())
+        {
+            hint = {m_mines.back(), true};
+            return true;
+        }
+        return false;
+    }
+
+    // true if the tile is opened (a constraint)
+    bool Solver::isOpened(const Tile& tile) // static
+    {
+        return tile.m_state == TileState::notHidden && !tile.m_isMine;
+    }
+
+    // queues a constraint (opened tile) to be examined
+    void Solver::enqueue(uint32_t tileIndex1D)
+    {
+        if (m_queued[tileIndex1D])
+            return;
+        m_queued[tileIndex1D] = true;
+        m_queue.push_back(tileIndex1D);
+    }
+
+    // queues opened neighbours of a tile (their constraint changed)
+    void Solver::enqueueNeighbours(uint32_t tileIndex1D)
+    {
+        m_board->forEachNeighbour(tileIndex1D, [this](uint32_t neighbour, const Tile& tile)
+        {
+            if (isOpened(tile))
+                enqueue(neighbour);
+        });
+    }
+
+    // stores a deduction and queues the constraints around it
+    void Solver::setKnown(uint32_t tileIndex1D, Knowledge knowledge)
+    {
+        if (m_known[tileIndex1D] != Knowledge::unknown)
+            return;
+        m_known[tileIndex1D] = knowledge;
+        (knowledge == Knowledge::safe ? m_safe : m_mines).push_back(tileIndex1D);
+        enqueueNeighbours(tileIndex1D);
+    }
+
+    /**
+     * @brief unknown hidden neighbours of a number and the mines still missing around it
+     *
+     */
+    int Solver::constraint(uint32_t tileIndex1D, uint32_t* unknown, uint32_t& unknownCount) const
+    {
+        int remaining = m_board->tile(tileIndex1D).m_mineCounter;
+        unknownCount = 0;
+        m_board->forEachNeighbour(tileIndex1D, [&](uint32_t neighbour, const Tile&)
+        {
+            const Knowledge known = m_known[neighbour];
+            if (known == Knowledge::mine)
+                remaining--;
+            else if (known == Knowledge::unknown)
+                unknown[unknownCount++] = neighbour;
+        });
+        return remaining;
+    }
+
+    /**
+     * @brief single-tile and subset rules on one number
+     *
+     */
+    void Solver::examine(uint32_t tileIndex1D)
+    {
+        uint32_t unknown[8];
+        uint32_t unknownCount;
+        const int remaining = constraint(tileIndex1D, unknown, unknownCount);
+        if (unknownCount == 0)
+            return;
+
+        // single-tile rules: all mines found -> rest is safe, as many unknowns as mines -> all mines
+        if (remaining == 0 || remaining == int(unknownCount))
+        {
+            const Knowledge knowledge = remaining == 0 ? Knowledge::safe : Knowledge::mine;
+            for (uint32_t i = 0; i < unknownCount; ++i)
+                setKnown(unknown[i], knowledge);
+            return;
+        }
+
+        // subset rules with numbers sharing unknown tiles (at most 2 tiles away)
+        const uint32_t width = m_board->width();
+        const uint32_t height = m_board->height();
+        const uint32_t row = tileIndex1D / width;
+        const uint32_t col = tileIndex1D % width;
+        for (uint32_t i = row > 2 ? row - 2 : 0; i <= std::min(row + 2, height - 1); ++i)
+        {
+            for (uint32_t j = col > 2 ? col - 2 : 0; j <= std::min(col + 2, width - 1); ++j)
+            {
+                const uint32_t other = i * width + j;
+                if (other == tileIndex1D || !isOpened(other))
+                    continue;
+
+                uint32_t otherUnknown[8];
+                uint32_t otherCount;
+                const int otherRemaining = constraint(other, otherUnknown, otherCount);
+                if (otherCount <= unknownCount)
+                    continue;
+
+                // this number's unknowns must all be around the other number
+                uint32_t shared = 0;
+                for (uint32_t a = 0; a < unknownCount; ++a)
+                    for (uint32_t b = 0; b < otherCount; ++b)
+                        shared += unknown[a] == otherUnknown[b];
+                if (shared != unknownCount)
+                    continue;
+
+                // the other's extra unknowns hold exactly the difference of mines
+                const int difference = otherRemaining - remaining;
+                const uint32_t extra = otherCount - unknownCount;
+                if (difference != 0 && difference != int(extra))
+                    continue;
+                const Knowledge knowledge = difference == 0 ? Knowledge::safe : Knowledge::mine;
+                for (uint32_t b = 0; b < otherCount; ++b)
+                {
+                    if (std::find(unknown, unknown + unknownCount, otherUnknown[b]) == unknown + unknownCount)
+                        setKnown(otherUnknown[b], knowledge);
+                }
+            }
+        }
+
+        // still undecided: its unknowns need enumeration
+        for (uint32_t i = 0; i < unknownCount; ++i)
+        {
+            if (m_known[unknown[i]] == Knowledge::unknown && !m_isDirty[unknown[i]])
+            {
+                m_isDirty[unknown[i]] = true;
+                m_dirty.push_back(unknown[i]);
+            }
+        }
+    }
+
+    /**
+     * @brief exact enumeration of frontier components containing dirty tiles
+     *
+     */
+    void Solver::enumerateDirtyComponents()
+    {
+        // dirty list may grow while enumerating (new deductions), take current ones
+        std::vector<uint32_t> dirty;
+        dirty.swap(m_dirty);
+        for (uint32_t tileIndex1D : dirty)
+            m_isDirty[tileIndex1D] = false;
+
+        for (uint32_t tileIndex1D : dirty)
+        {
+            // already decided, or in a component enumerated just now
+            if (m_known[tileIndex1D] != Knowledge::unknown || m_variable[tileIndex1D] == -2)
+                continue;
+            enumerateComponent(tileIndex1D);
+        }
+        // forget the component marks of this pass
+        for (uint32_t tileIndex1D : m_enumerated)
+            m_variable[tileIndex1D] = -1;
+        m_enumerated.clear();
+    }
+
+    /**
+     * @brief enumerates one component starting from a frontier tile
+     *
+     */
+    void Solver::enumerateComponent(uint32_t start)
+    {
+        // collect the component: unknown tiles linked by numbers they share (BFS)
+        m_component.clear();
+        m_constraints.clear();
+        m_component.push_back(start);
+        m_variable[start] = 0;
+        bool tooBig = false;
+        for (size_t head = 0; head < m_component.size() && !tooBig; ++head)
+        {
+            m_board->forEachNeighbour(m_component[head], [&](uint32_t number, const Tile& tile)
+            {
+                if (tooBig || !isOpened(tile) || m_inComponent[number])
+                    return;
+                m_inComponent[number] = true;
+                m_constraints.push_back(number);
+
+                uint32_t unknown[8];
+                uint32_t unknownCount;
+                constraint(number, unknown, unknownCount);
+                for (uint32_t u = 0; u < unknownCount; ++u)
+                {
+                    // -2: touches a component too big to enumerate earlier in this pass
+                    if (m_variable[unknown[u]] == -2)
+                        tooBig = true;
+                    if (m_variable[unknown[u]] != -1)
+                        continue;
+                    if (m_component.size() == maxComponentSize)
+                    {
+                        tooBig = true;
+                        break;
+                    }
+                    m_variable[unknown[u]] = int32_t(m_component.size());
+                    m_component.push_back(unknown[u]);
+                }
+            });
+        }
+
+        if (!tooBig)
+        {
+            Enumeration enumeration;
+            enumeration.constraints.resize(m_constraints.size());
+            enumeration.constraintsOf.resize(m_component.size());
+            enumeration.assignment.assign(m_component.size(), false);
+            enumeration.mineSolutions.assign(m_component.size(), 0);
+            for (uint32_t c = 0; c < m_constraints.size(); ++c)
+            {
+                uint32_t unknown[8];
+                uint32_t unknownCount;
+                enumeration.constraints[c].remaining = constraint(m_constraints[c], unknown, unknownCount);
+                enumeration.constraints[c].unassigned = unknownCount;
+                for (uint32_t u = 0; u < unknownCount; ++u)
+                    enumeration.constraintsOf[m_variable[unknown[u]]].push_back(c);
+            }
+            enumeration.run(0);
+
+            // tiles that are mines in every solution or in none are decided
+            if (!enumeration.aborted && enumeration.solutions > 0)
+            {
+                for (uint32_t v = 0; v < m_component.size(); ++v)
+                {
+                    if (enumeration.mineSolutions[v] == 0)
+                        setKnown(m_component[v], Knowledge::safe);
+                    else if (enumeration.mineSolutions[v] == enumeration.solutions)
+                        setKnown(m_component[v], Knowledge::mine);
+                }
+            }
+        }
+
+        // -2 marks "enumerated in this pass" so other dirty tiles of the component are skipped
+        for (uint32_t tileIndex1D : m_component)
+            m_variable[tileIndex1D] = -2;
+        m_enumerated.insert(m_enumerated.end(), m_component.begin(), m_component.end());
+        for (uint32_t number : m_constraints)
+            m_inComponent[number] = false;
+    }
+};
@@ -0,0 +1,127 @@
+// ThreadPool.cpp
+#include <ThreadPool.h>
+#include <algorithm>
+
+namespace game
+{
+    namespace
+    {
+        // worker index of the current thread, and the pool it belongs to
+        thread_local const ThreadPool* currentPool = nullptr;
+        thread_local uint32_t currentIndex = 0;
+    }
+
+    /**
+     * @brief starts the workers
+     *
+     */
+    ThreadPool::ThreadPool(uint32_t threads)
+    {
+        if (threads == 0)
+            threads = std::max(2u, std::thread::hardware_concurrency()) - 1; // hardware_concurrency is 0 if unknown
+        for (uint32_t i = 0; i < threads; ++i)
+            m_workers.push_back(std::make_unique<Worker>());
+        for (uint32_t i = 0; i < threads; ++i)
+            m_threads.emplace_back(&ThreadPool::run, this, i);
+    }
+
+    // drops queued tasks and joins the workers
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+            m_stop = true;
+        }
+        m_wakeUp.notify_all();
+        for (std::thread& thread : m_threads)
+            thread.join();
+    }
+
+    void ThreadPool::submit(std::function<void()> task)
+    {
+        push(std::move(task), false);
+    }
+
+    /**
+     * @brief like submit, but from a worker the task goes behind the tasks already queued on it
+     *
+     */
+    void ThreadPool::defer(std::function<void()> task)
+    {
+        push(std::move(task), true);
+    }
+
+    // queues a task on the current worker (round robin from outside), at the front of its deque if last
+    void ThreadPool::push(std::function<void()> task, bool last)
+    {
+        uint32_t worker = currentWorker();
+        if (worker == size())
+            worker = m_nextWorker.fetch_add(1, std::memory_order_relaxed) % size();
+        {
+            std::lock_guard<std::mutex> lock(m_workers[worker]->mutex);
+            if (last)
+                m_workers[worker]->tasks.push_front(std::move(task));
+            else
+                m_workers[worker]->tasks.push_back(std::move(task));
+        }
+        {
+            // under the sleep lock so a worker can't miss the wake-up between its check and its wait
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+            m_pending.fetch_add(1, std::memory_order_relaxed);
+        }
+        m_wakeUp.notify_one();
+    }
+
+    // index of the worker running the calling thread
+    uint32_t ThreadPool::currentWorker() const
+    {
+        return currentPool == this ? currentIndex : size();
+    }
+
+    // worker thread loop
+    void ThreadPool::run(uint32_t worker)
+    {
+        currentPool = this;
+        currentIndex = worker;
+        std::function<void()> task;
+        while (true)
+        {
+            if (take(worker, task))
+            {
+                task();
+                task = nullptr;
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(m_sleepMutex);
+            m_wakeUp.wait(lock, [this]() { return m_stop || m_pending.load(std::memory_order_relaxed) > 0; });
+            if (m_stop)
+                return;
+        }
+    }
+
+    // own newest task, or another worker's oldest one
+    bool ThreadPool::take(uint32_t worker, std::function<void()>& task)
+    {
+        for (uint32_t i = 0; i < size(); ++i)
+        {
+            const uint32_t victim = (worker + i) % size();
+            Worker& queue = *m_workers[victim];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.tasks.empty())
+                continue;
+            if (victim == worker)
+            {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            }
+            else
+            {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+            m_pending.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+};
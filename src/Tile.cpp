@@ -1,33 +1,59 @@
 // Tile.cpp
 #include <Tile.h>
+#include <array>
 
 namespace game
 {
+    namespace
+    {
+        // tileset index of an unpacked tile
+        constexpr mapIndex mapIndexOf(uint8_t mineCounter, bool isMine, TileState state)
+        {
+            if (state == TileState::hidden)
+                return mapIndex::hidden;
+
+            else if (state == TileState::flagged)
+                return mapIndex::flag;
+
+            else if (state == TileState::peek)
+                return mapIndex::empty;
+
+            else if (state == TileState::mineClicked && isMine)
+                return mapIndex::mineClicked;
+
+            else if (isMine)
+                return mapIndex::mine;
+            else
+                return static_cast<mapIndex>(mineCounter);
+        }
+
+        // tileset index of every packed tile (see Tile::pack)
+        constexpr std::array<mapIndex, 256> makeMapIndexTable()
+        {
+            std::array<mapIndex, 256> table {};
+            for (uint32_t packed = 0; packed < 256; ++packed)
+                table[packed] = mapIndexOf(uint8_t(packed & 0x0f), (packed >> 4) & 1, TileState(packed >> 5));
+            return table;
+        }
+
+        constexpr std::array<mapIndex, 256> mapIndexTable = makeMapIndexTable();
+    }
+
     mapIndex Tile::getMapIndex() const {
         return getMapIndex(*this);
     }
 
     mapIndex Tile::getMapIndex(const Tile& tile) // static
     {
-        const auto& state = tile.m_state;
-        const auto& isMine = tile.m_isMine;
-        const auto& mineCounter = tile.m_mineCounter;
-
-        if (state == TileState::hidden)
-            return mapIndex::hidden;
-
-        else if (state == TileState::flagged)
-            return mapIndex::flag;
-
-        else if (state == TileState::peek)
-            return mapIndex::empty;
-
-        else if (state == TileState::mineClicked && isMine)
-            return mapIndex::mineClicked;
+        return mapIndexTable[tile.pack()];
+    }
 
-        else if (isMine)
-            return mapIndex::mine;
-        else
-            return static_cast<mapIndex>(mineCounter);
+    Tile Tile::unpack(uint8_t packed) // static
+    {
+        Tile tile;
+        tile.m_mineCounter = packed & 0x0f;
+        tile.m_isMine = (packed >> 4) & 1;
+        tile.m_state = TileState(packed >> 5);
+        return tile;
     }
-};
\ No newline at end of file
+};
@@ -0,0 +1,360 @@
+// bench.cpp
+// Microbenchmarks of the hot paths, results as JSON (compare runs between versions)
+#include <SFML/Graphics.hpp>
+#include <BitBoard.h>
+#include <Board.h>
+#include <BoardMetrics.h>
+#include <ParallelFlood.h>
+#include <Tilemap.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace game;
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct BenchResult
+    {
+        std::string name;
+        std::string unit; // what one op is (ns are per op)
+        uint32_t width = 0;
+        uint32_t height = 0;
+        float density = 0.f;
+        uint64_t samples = 0;
+        uint64_t ops = 0;
+        double minNs = 0.0; // fastest sample
+        double medianNs = 0.0;
+        double meanNs = 0.0; // all ops / all time
+    };
+
+    struct BoardCase
+    {
+        uint32_t width;
+        uint32_t height;
+        float density;
+    };
+
+    /**
+     * @brief times run() for minSeconds of wall time (setup included, at least minSamples samples)
+     * only run() is timed
+     *
+     * @param setup prepares one sample
+     * @param run timed part, returns the number of ops it did
+     */
+    BenchResult measure(const std::string& name, const std::string& unit, const BoardCase& boardCase,
+                        double minSeconds, const std::function<void()>& setup,
+                        const std::function<uint64_t()>& run)
+    {
+        const uint64_t minSamples = 5;
+        const uint64_t maxSamples = 100000;
+
+        BenchResult result;
+        result.name = name;
+        result.unit = unit;
+        result.width = boardCase.width;
+        result.height = boardCase.height;
+        result.density = boardCase.density;
+
+        std::vector<double> perOp;
+        double totalNs = 0.0;
+        const Clock::time_point end = Clock::now() +
+            std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(minSeconds));
+        while (result.samples < maxSamples && (result.samples < minSamples || Clock::now() < end))
+        {
+            setup();
+            const Clock::time_point start = Clock::now();
+            const uint64_t ops = std::max<uint64_t>(1, run());
+            const double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+            totalNs += ns;
+            result.ops += ops;
+            result.samples++;
+            perOp.push_back(ns / ops);
+        }
+        std::sort(perOp.begin(), perOp.end());
+        result.minNs = perOp.front();
+        result.medianNs = perOp[perOp.size() / 2];
+        result.meanNs = totalNs / result.ops;
+        return result;
+    }
+
+    uint32_t minesOf(const BoardCase& boardCase)
+    {
+        return uint32_t(double(boardCase.width) * boardCase.height * boardCase.density);
+    }
+
+    uint32_t center(const BoardCase& boardCase)
+    {
+        return boardCase.height / 2 * boardCase.width + boardCase.width / 2;
+    }
+
+    // Board::generate from the first click
+    BenchResult benchGenerate(const BoardCase& boardCase, double minSeconds, TileLayoutKind layout)
+    {
+        Board board;
+        board.setHeadless(true);
+        board.setLayout(layout);
+        uint64_t seed = 0;
+        return measure(layout == TileLayoutKind::blocked ? "generate.blocked" : "generate", "board", boardCase, minSeconds,
+            [&]() { board.reset(boardCase.width, boardCase.height, minesOf(boardCase)); },
+            [&]() { board.generate(center(boardCase), seed++, 1); return uint64_t(1); });
+    }
+
+    // first click flood fill (ns per opened tile)
+    BenchResult benchReveal(const BoardCase& boardCase, double minSeconds, TileLayoutKind layout)
+    {
+        Board board;
+        board.setLayout(layout);
+        uint64_t seed = 0;
+        return measure(layout == TileLayoutKind::blocked ? "reveal.blocked" : "reveal", "tile", boardCase, minSeconds,
+            [&]()
+            {
+                board.reset(boardCase.width, boardCase.height, minesOf(boardCase));
+                board.generate(center(boardCase), seed++, 1);
+                board.clearChanges();
+            },
+            [&]() { board.reveal(center(boardCase)); return uint64_t(board.revealed().size()); });
+    }
+
+    // first click flood fill of a huge region on all cores (ns per opened tile, compare with "reveal")
+    BenchResult benchParallelReveal(const BoardCase& boardCase, double minSeconds, ThreadPool& pool)
+    {
+        Board board;
+        ParallelFlood flood(pool);
+        board.setParallelFlood(&flood);
+        uint64_t seed = 0;
+        return measure("reveal.parallel", "tile", boardCase, minSeconds,
+            [&]()
+            {
+                board.reset(boardCase.width, boardCase.height, minesOf(boardCase));
+                board.generate(center(boardCase), seed++, 1);
+                board.clearChanges();
+            },
+            [&]() { board.reveal(center(boardCase)); return uint64_t(board.revealed().size()); });
+    }
+
+    // peek + chord (what Game::peekNeighbours does) on every number around the first opening
+    BenchResult benchChord(const BoardCase& boardCase, double minSeconds)
+    {
+        Board board;
+        board.setHeadless(true);
+        std::vector<uint32_t> numbers;
+        uint64_t seed = 0;
+        return measure("chord", "chord", boardCase, minSeconds,
+            [&]()
+            {
+                board.reset(boardCase.width, boardCase.height, minesOf(boardCase));
+                board.generate(center(boardCase), seed++, 1);
+                board.reveal(center(boardCase));
+
+                // flag mines around opened numbers (one flag less than mines, so the game goes on)
+                numbers.clear();
+                std::vector<uint32_t> opened(board.revealed());
+                for (uint32_t tileIndex1D : opened)
+                {
+                    if (board.tile(tileIndex1D).m_mineCounter == 0)
+                        continue;
+                    bool flagged = true;
+                    board.forEachNeighbour(tileIndex1D, [&](uint32_t neighbourIndex1D, const Tile& neighbour)
+                    {
+                        if (flagged && neighbour.m_isMine && neighbour.m_state == TileState::hidden)
+                            flagged = board.flags() + 1 < board.mines() && board.toggleFlag(neighbourIndex1D);
+                    });
+                    if (flagged)
+                        numbers.push_back(tileIndex1D);
+                }
+            },
+            [&]()
+            {
+                for (uint32_t tileIndex1D : numbers)
+                {
+                    board.peek(tileIndex1D, true);
+                    board.chord(tileIndex1D);
+                }
+                return uint64_t(numbers.size());
+            });
+    }
+
+    // neighbour walk of every tile counting mined and flagged neighbours (what chord and the solver do)
+    BenchResult benchNeighbours(const BoardCase& boardCase, double minSeconds)
+    {
+        Board board;
+        board.setHeadless(true);
+        board.reset(boardCase.width, boardCase.height, minesOf(boardCase));
+        board.generate(center(boardCase), 0, 1);
+
+        volatile uint32_t sink = 0;
+        return measure("neighbours", "tile", boardCase, minSeconds,
+            []() {},
+            [&]()
+            {
+                uint32_t counted = 0;
+                for (uint32_t tileIndex1D = 0; tileIndex1D < board.size(); ++tileIndex1D)
+                {
+                    board.forEachNeighbour(tileIndex1D, [&](uint32_t, const Tile& neighbour)
+                    {
+                        counted += neighbour.m_isMine + (neighbour.m_state == TileState::flagged);
+                    });
+                }
+                sink = counted;
+                return uint64_t(board.size());
+            });
+    }
+
+    // 3BV, openings and isolated numbers of a generated board (what minesweeper_boardgen does per board)
+    BenchResult benchMetrics(const BoardCase& boardCase, double minSeconds)
+    {
+        Board board;
+        board.setHeadless(true);
+        MetricsScratch scratch;
+        uint64_t seed = 0;
+        volatile uint32_t sink = 0;
+        return measure("metrics", "board", boardCase, minSeconds,
+            [&]()
+            {
+                board.reset(boardCase.width, boardCase.height, minesOf(boardCase));
+                board.generate(center(boardCase), seed++, 1);
+            },
+            [&]() { sink = computeMetrics(board, scratch).bbbv; return uint64_t(1); });
+    }
+
+    // checkWin with every mine flagged (was the full-scan worst case before the win counters)
+    BenchResult benchCheckWin(const BoardCase& boardCase, double minSeconds)
+    {
+        Board board;
+        board.setHeadless(true);
+        board.reset(boardCase.width, boardCase.height, minesOf(boardCase));
+        board.generate(center(boardCase), 0, 1);
+        for (uint32_t tileIndex1D = 0; tileIndex1D < board.size(); ++tileIndex1D)
+            if (board.tile(tileIndex1D).m_isMine)
+                board.toggleFlag(tileIndex1D);
+
+        volatile bool won = false;
+        return measure("checkWin", "call", boardCase, minSeconds,
+            []() {},
+            [&]() { won = board.checkWin(); return uint64_t(1); });
+    }
+
+    // Tilemap::updateTile of every tile (false if the tileset couldn't be loaded)
+    bool benchUpdateTile(const BoardCase& boardCase, double minSeconds, bool shader, BenchResult& result)
+    {
+        const uint32_t size = boardCase.width * boardCase.height;
+        std::vector<uint16_t> tiles(size, uint16_t(mapIndex::hidden));
+        Tilemap tilemap;
+        tilemap.setShaderEnabled(shader);
+        if (!tilemap.load("res/png/tilemap-new-32.png", {32u, 32u}, tiles.data(), boardCase.width, boardCase.height) ||
+            tilemap.usesShader() != shader)
+            return false;
+
+        uint16_t tileNumber = 0;
+        result = measure(shader ? "updateTile.shader" : "updateTile.vertex", "tile", boardCase, minSeconds,
+            [&]() { tileNumber = uint16_t((tileNumber + 1) % mapIndex::mineClicked); },
+            [&]()
+            {
+                for (uint32_t tileIndex1D = 0; tileIndex1D < size; ++tileIndex1D)
+                    tilemap.updateTile(tileIndex1D, tileNumber);
+                return uint64_t(size);
+            });
+        return true;
+    }
+
+    std::string toJson(const std::vector<BenchResult>& results)
+    {
+        std::ostringstream json;
+        json << "{\n";
+        json << "  \"countKernel\": \"" << (BitBoard::bestKernel() == CountKernel::avx2 ? "avx2" : "scalar") << "\",\n";
+        json << "  \"hardwareThreads\": " << std::thread::hardware_concurrency() << ",\n";
+        json << "  \"benchmarks\": [\n";
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const BenchResult& result = results[i];
+            json << "    {\"name\": \"" << result.name << "\", \"unit\": \"" << result.unit
+                 << "\", \"width\": " << result.width << ", \"height\": " << result.height
+                 << ", \"density\": " << result.density << ", \"samples\": " << result.samples
+                 << ", \"ops\": " << result.ops << ", \"minNs\": " << result.minNs
+                 << ", \"medianNs\": " << result.medianNs << ", \"meanNs\": " << result.meanNs << "}"
+                 << (i + 1 < results.size() ? ",\n" : "\n");
+        }
+        json << "  ]\n}\n";
+        return json.str();
+    }
+}
+
+// usage: minesweeper_bench [--quick] [--no-render] [--out file.json]
+int main(int argc, char** argv)
+{
+    bool quick = false;
+    bool render = true;
+    std::string outPath;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--quick") == 0)
+            quick = true;
+        else if (std::strcmp(argv[i], "--no-render") == 0)
+            render = false;
+        else if (std::strcmp(argv[i], "--out") == 0 && i + 1 < argc)
+            outPath = argv[++i];
+        else
+        {
+            std::cerr << "usage: minesweeper_bench [--quick] [--no-render] [--out file.json]\n";
+            return 1;
+        }
+    }
+
+    // classic sizes, then big boards (sparse boards have big openings)
+    std::vector<BoardCase> cases = {
+        {9, 9, 0.12f}, {16, 16, 0.16f}, {30, 16, 0.21f},
+        {256, 256, 0.05f}, {256, 256, 0.15f}, {256, 256, 0.25f},
+    };
+    if (!quick)
+    {
+        cases.push_back({1024, 1024, 0.05f});
+        cases.push_back({1024, 1024, 0.15f});
+        cases.push_back({1024, 1024, 0.25f});
+    }
+    const double minSeconds = quick ? 0.02 : 0.2;
+    ThreadPool pool;
+
+    std::vector<BenchResult> results;
+    for (const BoardCase& boardCase : cases)
+    {
+        results.push_back(benchGenerate(boardCase, minSeconds, TileLayoutKind::rowMajor));
+        results.push_back(benchReveal(boardCase, minSeconds, TileLayoutKind::rowMajor));
+        // 8x8 blocks only pay off once a row no longer fits in cache next to its neighbours
+        if (boardCase.width >= 256)
+        {
+            results.push_back(benchGenerate(boardCase, minSeconds, TileLayoutKind::blocked));
+            results.push_back(benchReveal(boardCase, minSeconds, TileLayoutKind::blocked));
+        }
+        // only boards that big take the parallel path
+        if (boardCase.width * boardCase.height >= parallelFloodMinSize)
+            results.push_back(benchParallelReveal(boardCase, minSeconds, pool));
+        results.push_back(benchChord(boardCase, minSeconds));
+        results.push_back(benchNeighbours(boardCase, minSeconds));
+        results.push_back(benchMetrics(boardCase, minSeconds));
+        results.push_back(benchCheckWin(boardCase, minSeconds));
+        for (bool shader : {false, true})
+        {
+            BenchResult result;
+            if (render && benchUpdateTile(boardCase, minSeconds, shader, result))
+                results.push_back(result);
+        }
+        std::cerr << boardCase.width << "x" << boardCase.height << " " << boardCase.density << " done\n";
+    }
+
+    const std::string json = toJson(results);
+    if (outPath.empty())
+        std::cout << json;
+    else
+        std::ofstream(outPath) << json;
+    return 0;
+}
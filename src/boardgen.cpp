@@ -0,0 +1,178 @@
+// boardgen.cpp
+// Generates many boards on all cores and writes their difficulty (3BV, openings, isolated numbers)
+#include <BoardMetrics.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+    #include <fcntl.h>
+    #include <io.h>
+#endif
+
+namespace
+{
+    const uint8_t magic[4] = {'M', 'S', 'B', 'M'};
+    const uint8_t version = 1;
+
+    void writeLittleEndian(std::vector<uint8_t>& bytes, uint64_t value, uint32_t size)
+    {
+        for (uint32_t i = 0; i < size; ++i)
+            bytes.push_back(uint8_t(value >> (8 * i)));
+    }
+
+    /**
+     * @brief binary header: magic, version, bytes per field, width, height, mines, first click,
+     * safe radius (u32 each), seed and boards (u64 each), all little endian
+     * then one record per board in seed order: 3BV, openings, isolated numbers
+     * (u16 each if the board has at most 65535 tiles, else u32)
+     */
+    std::vector<uint8_t> binaryHeader(const game::MetricsBatchConfig& config, uint32_t fieldBytes)
+    {
+        std::vector<uint8_t> bytes(magic, magic + 4);
+        bytes.push_back(version);
+        bytes.push_back(uint8_t(fieldBytes));
+        for (uint32_t value : {config.width, config.height, config.mines, config.firstClick, config.safeRadius})
+            writeLittleEndian(bytes, value, 4);
+        writeLittleEndian(bytes, config.seed, 8);
+        writeLittleEndian(bytes, config.boards, 8);
+        return bytes;
+    }
+}
+
+// usage: minesweeper_boardgen [--boards N] [--seed S] [--mines M] [--threads T] [--csv] [--out file] [width height [mine density]]
+int main(int argc, char** argv)
+{
+    game::MetricsBatchConfig config;
+    config.boards = 1000;
+    bool csv = false;
+    bool minesGiven = false;
+    std::string outPath;
+    std::vector<char*> args;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--boards") == 0 && i + 1 < argc)
+            config.boards = std::stoull(argv[++i]);
+        else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+            config.seed = std::stoull(argv[++i]);
+        else if (std::strcmp(argv[i], "--mines") == 0 && i + 1 < argc)
+        {
+            config.mines = uint32_t(std::stoul(argv[++i]));
+            minesGiven = true;
+        }
+        else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            config.threads = uint32_t(std::stoul(argv[++i]));
+        else if (std::strcmp(argv[i], "--csv") == 0)
+            csv = true;
+        else if (std::strcmp(argv[i], "--out") == 0 && i + 1 < argc)
+            outPath = argv[++i];
+        else if (argv[i][0] == '-')
+        {
+            std::cerr << "usage: minesweeper_boardgen [--boards N] [--seed S] [--mines M] [--threads T] [--csv] [--out file] "
+                      << "[width height [mine density]]\n";
+            return 1;
+        }
+        else
+            args.push_back(argv[i]);
+    }
+
+    // expert board by default
+    if (args.size() >= 2)
+    {
+        const uint64_t width = std::max(1ull, std::stoull(args[0]));
+        const uint64_t height = std::max(1ull, std::stoull(args[1]));
+        // tile indices are 32-bit
+        if (!game::Board::fits(width, height))
+        {
+            std::cerr << "board too big: " << width << "x" << height << "\n";
+            return 1;
+        }
+        config.width = uint32_t(width);
+        config.height = uint32_t(height);
+    }
+    if (args.size() >= 3 && !minesGiven)
+        config.mines = uint32_t(double(config.width) * config.height * std::clamp(std::stof(args[2]), 0.f, 1.f));
+    if (config.width * config.height < 2)
+    {
+        std::cerr << "board needs at least 2 tiles\n";
+        return 1;
+    }
+    config.mines = std::min(config.mines, config.width * config.height - 1);
+    // first click in the middle, like most puzzle sets
+    config.firstClick = config.height / 2 * config.width + config.width / 2;
+
+    std::ofstream file;
+    if (!outPath.empty())
+    {
+        file.open(outPath, csv ? std::ios::out : std::ios::out | std::ios::binary);
+        if (!file)
+        {
+            std::cerr << "couldn't create " << outPath << "\n";
+            return 1;
+        }
+    }
+    std::ostream& out = outPath.empty() ? std::cout : file;
+#ifdef _WIN32
+    // stdout is in text mode on Windows: every 0x0A of the binary output would become 0x0D 0x0A
+    if (outPath.empty() && !csv)
+    {
+        std::cout.flush();
+        _setmode(_fileno(stdout), _O_BINARY);
+    }
+#endif
+
+    // results are streamed batch by batch (never the whole set in memory)
+    const uint32_t fieldBytes = config.width * config.height <= UINT16_MAX ? 2 : 4;
+    std::vector<uint8_t> bytes;
+    std::string text;
+    if (csv)
+        out << "seed,3bv,openings,isolated\n";
+    else
+    {
+        bytes = binaryHeader(config, fieldBytes);
+        out.write(reinterpret_cast<const char*>(bytes.data()), std::streamsize(bytes.size()));
+    }
+
+    uint64_t totalBbbv = 0;
+    const auto start = std::chrono::steady_clock::now();
+    game::generateMetrics(config, [&](uint64_t first, const std::vector<game::BoardMetrics>& batch)
+    {
+        bytes.clear();
+        text.clear();
+        for (size_t i = 0; i < batch.size(); ++i)
+        {
+            const game::BoardMetrics& metrics = batch[i];
+            totalBbbv += metrics.bbbv;
+            if (csv)
+            {
+                text += std::to_string(config.seed + first + i);
+                for (uint32_t value : {metrics.bbbv, metrics.openings, metrics.isolatedNumbers})
+                {
+                    text += ',';
+                    text += std::to_string(value);
+                }
+                text += '\n';
+            }
+            else
+            {
+                for (uint32_t value : {metrics.bbbv, metrics.openings, metrics.isolatedNumbers})
+                    writeLittleEndian(bytes, value, fieldBytes);
+            }
+        }
+        if (csv)
+            out.write(text.data(), std::streamsize(text.size()));
+        else
+            out.write(reinterpret_cast<const char*>(bytes.data()), std::streamsize(bytes.size()));
+    });
+    out.flush();
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cerr << config.boards << " boards " << config.width << "x" << config.height << " (" << config.mines
+              << " mines) in " << seconds << " s (" << (seconds > 0.0 ? double(config.boards) / seconds : 0.0)
+              << " boards/s), mean 3BV " << (config.boards > 0 ? double(totalBbbv) / config.boards : 0.0) << "\n";
+    return out ? 0 : 2;
+}
@@ -1,25 +1,150 @@
 #include <SFML/Graphics.hpp>
 #include <Tilemap.h>
 #include <Game.h>
+#include <EndlessGame.h>
+#include <random>
+#include <string>
+#include <vector>
 
-int main()
+// endless mode: positional args are [mine density [seed]]
+int playEndless(int argc, char** argv)
 {
+    float mineDensity = game::defaultEndlessMineDensity;
+    if (argc >= 2)
+        mineDensity = std::clamp(std::stof(argv[1]), 0.f, 1.f);
+    const bool fixedSeed = argc >= 3;
+    uint64_t seed = fixedSeed ? std::stoull(argv[2]) : 0;
+    std::random_device randomDevice;
+
+    game::AssetCache::instance().preload({game::tileset32Path, game::tileset64Path, game::iconPath}, {game::fontPath});
+    short playOn64;
+    game::EndlessGame game;
+    do
+    {
+        std::cout << "Play on 32x32 or 64x64?\n"
+                  << "Enter [0] for 32x32 | [1] for 64x64 | [else] to exit game\n";
+        std::cin >> playOn64;
+        if (!fixedSeed)
+            seed = (uint64_t(randomDevice()) << 32) | randomDevice();
+        bool ready = false;
+        if (playOn64 == 1)
+            ready = game.init(game::tileset64Path, 64u, mineDensity, seed);
+        else if (playOn64 == 0)
+            ready = game.init(game::tileset32Path, 32u, mineDensity, seed);
+        if (!ready || !game.run())
+            break;
+
+    } while (true);
+    return 0;
+}
+
+// usage: main [--no-guess] [--record file] [--save file] [--profile file.csv] [--join host[:port]] [width height [mine density [seed]]]
+//        main --endless [mine density [seed]]
+int main(int argc, char** argv)
+{
+    // options can be anywhere, the rest are positional
+    bool noGuess = false;
+    bool endless = false;
+    std::string recordingPath;
+    std::string savePath;
+    std::string profilePath;
+    std::string joinAddress;
+    std::vector<char*> args;
+    for (int i = 0; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (i > 0 && arg == "--no-guess")
+            noGuess = true;
+        else if (i > 0 && arg == "--endless")
+            endless = true;
+        else if (i > 0 && arg == "--record" && i + 1 < argc)
+            recordingPath = argv[++i];
+        else if (i > 0 && arg == "--save" && i + 1 < argc)
+            savePath = argv[++i];
+        else if (i > 0 && arg == "--profile" && i + 1 < argc)
+            profilePath = argv[++i];
+        else if (i > 0 && arg == "--join" && i + 1 < argc)
+            joinAddress = argv[++i];
+        else
+            args.push_back(argv[i]);
+    }
+    argc = int(args.size());
+    argv = args.data();
+    // a board with no size: mines are made as the player gets to them
+    if (endless)
+    {
+        if (noGuess || !recordingPath.empty() || !savePath.empty() || !joinAddress.empty())
+            std::cout << "--no-guess, --record, --save and --join are ignored in endless games\n";
+        return playEndless(argc, argv);
+    }
+
+    // board size and mines are chosen at runtime
+    uint32_t width = game::defaultWidth;
+    uint32_t height = game::defaultHeight;
+    float mineDensity = game::defaultMineDensity;
+    if (argc >= 3)
+    {
+        const uint64_t argWidth = std::max(1ull, std::stoull(argv[1]));
+        const uint64_t argHeight = std::max(1ull, std::stoull(argv[2]));
+        // tile indices are 32-bit
+        if (!game::Board::fits(argWidth, argHeight))
+        {
+            std::cout << "board too big: " << argWidth << "x" << argHeight << "\n";
+            return 1;
+        }
+        width = uint32_t(argWidth);
+        height = uint32_t(argHeight);
+    }
+    if (argc >= 4)
+        mineDensity = std::clamp(std::stof(argv[3]), 0.f, 1.f);
+    const uint32_t mines = uint32_t(double(width) * height * mineDensity);
+    // a given seed replays the same levels, otherwise every game gets a new one
+    const bool fixedSeed = argc >= 5;
+    uint64_t seed = fixedSeed ? std::stoull(argv[4]) : 0;
+    std::random_device randomDevice;
+
+    // assets are decoded in the background while the player chooses
+    game::AssetCache::instance().preload({game::tileset32Path, game::tileset64Path, game::iconPath}, {game::fontPath});
+
     bool playAgain = false;
     short playOn64;
     game::Game game;
+    // co-op games are played on the server's board: nothing to record or resume locally
+    if (!joinAddress.empty() && (!recordingPath.empty() || !savePath.empty()))
+    {
+        std::cout << "--record and --save are ignored in co-op games\n";
+        recordingPath.clear();
+        savePath.clear();
+    }
+    game.setRecordingPath(recordingPath);
+    game.setSavePath(savePath);
+    if (!joinAddress.empty())
+    {
+        const size_t colon = joinAddress.find(':');
+        const unsigned short port = colon == std::string::npos ? game::coopDefaultPort
+                                                              : (unsigned short)std::stoul(joinAddress.substr(colon + 1));
+        game.setServer(joinAddress.substr(0, colon), port);
+    }
+#ifdef MINESWEEPER_PROFILER
+    game.setProfilePath(profilePath);
+#else
+    if (!profilePath.empty())
+        std::cout << "built without the profiler (MINESWEEPER_PROFILER=OFF), no profile written\n";
+#endif
     do
     {
         std::cout << "Play on 32x32 or 64x64?\nyou can change choose dimensions when game starts the next time\n"
                     << "Enter [0] for 32x32 | [1] for 64x64 | [else] to exit game\n";
         std::cin >> playOn64;
+        if (!fixedSeed)
+            seed = (uint64_t(randomDevice()) << 32) | randomDevice();
+        bool ready = false;
         if (playOn64 == 1)
-            game.init("res/png/tilemap-new-64.png", 64u);
+            ready = game.init(game::tileset64Path, 64u, width, height, mines, seed, noGuess);
         else if (playOn64 == 0)
-            game.init("res/png/tilemap-new-32.png", 32u);
-        else
-            break;
-
-        if (!game.run())
+            ready = game.init(game::tileset32Path, 32u, width, height, mines, seed, noGuess);
+        // missing assets or a server that can't be joined -> no game to run
+        if (!ready || !game.run())
             break;
 
     } while (true);
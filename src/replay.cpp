@@ -0,0 +1,65 @@
+// replay.cpp
+// Replays recorded games headless at full speed and checks they end the same way
+#include <Recording.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// usage: minesweeper_replay [--repeat N] recording...
+int main(int argc, char** argv)
+{
+    uint64_t repeat = 1;
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--repeat") == 0 && i + 1 < argc)
+            repeat = std::max<uint64_t>(1, std::stoull(argv[++i]));
+        else
+            paths.push_back(argv[i]);
+    }
+    if (paths.empty())
+    {
+        std::cerr << "usage: minesweeper_replay [--repeat N] recording...\n";
+        return 1;
+    }
+
+    std::vector<game::Recording> recordings(paths.size());
+    for (size_t i = 0; i < paths.size(); ++i)
+    {
+        if (!game::loadRecording(paths[i], recordings[i]))
+        {
+            std::cerr << paths[i] << ": not a valid recording\n";
+            return 1;
+        }
+    }
+
+    // one headless board for every replay
+    game::Board board;
+    board.setHeadless(true);
+    uint64_t mismatches = 0;
+    uint64_t actions = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (uint64_t r = 0; r < repeat; ++r)
+    {
+        for (size_t i = 0; i < recordings.size(); ++i)
+        {
+            const game::ReplayResult result = game::replay(recordings[i], board);
+            actions += result.actions;
+            if (result.matched)
+                continue;
+            mismatches++;
+            if (r == 0)
+                std::cerr << paths[i] << ": final state doesn't match the recording\n";
+        }
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const uint64_t sessions = repeat * recordings.size();
+    std::cout << sessions << " sessions, " << actions << " actions in " << seconds << " s ("
+              << (seconds > 0.0 ? double(sessions) / seconds : 0.0) << " sessions/s), "
+              << mismatches << " mismatches\n";
+    return mismatches == 0 ? 0 : 2;
+}
@@ -0,0 +1,182 @@
+// server.cpp
+// Co-op server: players on the network (main --join) play one board together, --bots load tests it
+#include <CoopClient.h>
+#include <CoopServer.h>
+#include <Random.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    /**
+     * @brief load test player: a client doing random legal actions at a fixed rate
+     * it knows the level (same seed as the server), so it only opens safe tiles and
+     * flags/unflags mines, the game lasts as long as the board
+     */
+    void runBot(unsigned short port, uint32_t bot, uint32_t rate, const std::atomic<bool>& stop,
+                std::atomic<uint64_t>& sent, std::atomic<uint64_t>& received)
+    {
+        game::CoopClient client;
+        game::Board board;
+        board.setHeadless(true);
+        if (!client.connect("127.0.0.1", port, board))
+        {
+            std::cerr << "bot " << bot << " couldn't connect\n";
+            return;
+        }
+        game::Random random(client.seed() + bot + 1);
+        auto start = std::chrono::steady_clock::now();
+        uint64_t actions = 0;
+        uint64_t actionsAtStart = 0; // actions sent before the level existed
+        bool levelSeen = false;
+        while (!stop && client.poll(board) && !board.isFinished())
+        {
+            // the first bot opens the middle, the others wait for the level
+            if (board.status() == game::GameStatus::notStarted)
+            {
+                if (bot == 0 && actions == 0)
+                {
+                    client.send(game::ActionType::reveal, board.height() / 2 * board.width() + board.width() / 2);
+                    actions++;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                continue;
+            }
+            // the rate counts from when the level exists (no burst of the actions due while waiting)
+            if (!levelSeen)
+            {
+                levelSeen = true;
+                start = std::chrono::steady_clock::now();
+                actionsAtStart = actions;
+            }
+
+            // actions due since the start (sent in bursts between sleeps)
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            const uint64_t due = actionsAtStart + uint64_t(seconds * rate);
+            for (; actions < due; ++actions)
+            {
+                const uint32_t tileIndex1D = random.bounded(board.size());
+                const game::Tile& tile = board.tile(tileIndex1D);
+                if (tile.m_state == game::TileState::notHidden)
+                    client.send(game::ActionType::chord, tileIndex1D);
+                else if (tile.m_isMine)
+                    client.send(game::ActionType::flag, tileIndex1D);
+                else if (tile.m_state == game::TileState::hidden)
+                    client.send(game::ActionType::reveal, tileIndex1D);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        sent += actions;
+        received += client.changesReceived();
+    }
+}
+
+// usage: minesweeper_server [--port P] [--threads T] [--bots N] [--rate R] [--seconds S] [width height [mine density [seed]]]
+int main(int argc, char** argv)
+{
+    unsigned short port = game::coopDefaultPort;
+    uint32_t threads = 0;
+    uint32_t bots = 0;
+    uint32_t rate = 1000;
+    double seconds = 10.0;
+    std::vector<char*> args;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--port") == 0 && i + 1 < argc)
+            port = (unsigned short)std::stoul(argv[++i]);
+        else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            threads = uint32_t(std::stoul(argv[++i]));
+        else if (std::strcmp(argv[i], "--bots") == 0 && i + 1 < argc)
+            bots = uint32_t(std::stoul(argv[++i]));
+        else if (std::strcmp(argv[i], "--rate") == 0 && i + 1 < argc)
+            rate = uint32_t(std::stoul(argv[++i]));
+        else if (std::strcmp(argv[i], "--seconds") == 0 && i + 1 < argc)
+            seconds = std::stod(argv[++i]);
+        else if (argv[i][0] == '-')
+        {
+            std::cerr << "usage: minesweeper_server [--port P] [--threads T] [--bots N] [--rate R] [--seconds S] "
+                      << "[width height [mine density [seed]]]\n";
+            return 1;
+        }
+        else
+            args.push_back(argv[i]);
+    }
+
+    // 100x100 by default: bots don't finish it in seconds, a client still loads it at once
+    uint32_t width = 100;
+    uint32_t height = 100;
+    float mineDensity = 0.16f;
+    if (args.size() >= 2)
+    {
+        const uint64_t argWidth = std::max(1ull, std::stoull(args[0]));
+        const uint64_t argHeight = std::max(1ull, std::stoull(args[1]));
+        // tile indices are 32-bit
+        if (!game::Board::fits(argWidth, argHeight))
+        {
+            std::cerr << "board too big: " << argWidth << "x" << argHeight << "\n";
+            return 1;
+        }
+        width = uint32_t(argWidth);
+        height = uint32_t(argHeight);
+    }
+    if (args.size() >= 3)
+        mineDensity = std::clamp(std::stof(args[2]), 0.f, 1.f);
+    const uint64_t seed = args.size() >= 4 ? std::stoull(args[3]) : uint64_t(std::random_device()());
+    if (uint64_t(width) * height < 2)
+    {
+        std::cerr << "board needs at least 2 tiles\n";
+        return 1;
+    }
+
+    game::SharedBoard board(width, height, uint32_t(double(width) * height * mineDensity), seed);
+    game::CoopServer server(board, threads);
+    if (!server.start(port))
+    {
+        std::cerr << "couldn't listen on port " << port << "\n";
+        return 1;
+    }
+    std::cout << "co-op server on port " << server.port() << ": " << width << "x" << height << ", "
+              << board.mines() << " mines, seed " << seed << "\n";
+
+    if (bots == 0)
+    {
+        // serves until the game is over and every player left
+        while (!board.isFinished() || server.clients() > 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        std::cout << (board.status() == game::GameStatus::won ? "won" : "lost") << " after "
+                  << server.actions() << " actions\n";
+        return 0;
+    }
+
+    // load test: bots play until time is up or the game is over
+    std::atomic<bool> stop {false};
+    std::atomic<uint64_t> sent {0};
+    std::atomic<uint64_t> received {0};
+    std::vector<std::thread> botThreads;
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t bot = 0; bot < bots; ++bot)
+        botThreads.emplace_back(runBot, server.port(), bot, rate, std::cref(stop), std::ref(sent), std::ref(received));
+    while (!board.isFinished() &&
+           std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() < seconds)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    // the last updates reach the bots before they stop
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    stop = true;
+    for (std::thread& thread : botThreads)
+        thread.join();
+
+    std::cout << bots << " bots, " << elapsed << " s: " << server.actions() << " actions ("
+              << double(server.actions()) / elapsed << "/s, " << sent << " sent), " << server.updatesSent()
+              << " updates, " << server.changesSent() << " tile changes sent (" << received << " received), "
+              << board.revealedSafe() << "/" << board.size() - board.mines() << " safe tiles open"
+              << (board.isFinished() ? (board.status() == game::GameStatus::won ? ", won" : ", lost") : "") << "\n";
+    return 0;
+}
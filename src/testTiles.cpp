@@ -1,5 +1,6 @@
 #include <SFML/Graphics.hpp>
 #include <Tilemap.h>
+#include <array>
 
 
 template <size_t size>
@@ -27,7 +28,7 @@ int main()
     // randomizeLevel(level, 3, 0);
     
 
-    TileMap map;
+    Tilemap map;
     if (!map.load("res/sfml-test-tileset.png", {32, 32}, level.data(), 16, 8))
         return -1;
 
@@ -0,0 +1,147 @@
+// BoardMetricsTest.cpp
+// Checks computeMetrics and generateMetrics against a plain BFS count of openings and isolated numbers
+#include <BoardMetrics.h>
+#include <Random.h>
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+using namespace game;
+
+namespace
+{
+    /**
+     * @brief 3BV the slow and obvious way: BFS every opening, count the numbers none of them touches
+     *
+     */
+    BoardMetrics referenceMetrics(const Board& board)
+    {
+        const int64_t width = board.width();
+        const int64_t height = board.height();
+        auto isEmpty = [&](int64_t x, int64_t y)
+        {
+            const Tile& tile = board.tile(uint32_t(y * width + x));
+            return !tile.m_isMine && tile.m_mineCounter == 0;
+        };
+
+        BoardMetrics metrics;
+        std::vector<uint8_t> visited(board.size(), 0);
+        std::vector<uint8_t> opened(board.size(), 0); // opened by some opening (its tiles and border)
+        std::vector<uint32_t> queue;
+        for (int64_t start = 0; start < int64_t(board.size()); ++start)
+        {
+            if (visited[start] || !isEmpty(start % width, start / width))
+                continue;
+            metrics.openings++;
+            visited[start] = 1;
+            queue.assign(1, uint32_t(start));
+            for (size_t head = 0; head < queue.size(); ++head)
+            {
+                const int64_t x = queue[head] % width;
+                const int64_t y = queue[head] / width;
+                opened[queue[head]] = 1;
+                for (int64_t dy = -1; dy <= 1; ++dy)
+                {
+                    for (int64_t dx = -1; dx <= 1; ++dx)
+                    {
+                        const int64_t nx = x + dx;
+                        const int64_t ny = y + dy;
+                        if (nx < 0 || ny < 0 || nx >= width || ny >= height)
+                            continue;
+                        const uint32_t neighbour = uint32_t(ny * width + nx);
+                        opened[neighbour] = 1;
+                        if (!visited[neighbour] && isEmpty(nx, ny))
+                        {
+                            visited[neighbour] = 1;
+                            queue.push_back(neighbour);
+                        }
+                    }
+                }
+            }
+        }
+        for (uint32_t i = 0; i < board.size(); ++i)
+        {
+            if (!board.tile(i).m_isMine && !opened[i])
+                metrics.isolatedNumbers++;
+        }
+        metrics.bbbv = metrics.openings + metrics.isolatedNumbers;
+        return metrics;
+    }
+
+    bool same(const BoardMetrics& a, const BoardMetrics& b)
+    {
+        return a.bbbv == b.bbbv && a.openings == b.openings && a.isolatedNumbers == b.isolatedNumbers;
+    }
+
+    void print(const BoardMetrics& metrics)
+    {
+        std::cerr << metrics.bbbv << "/" << metrics.openings << "/" << metrics.isolatedNumbers;
+    }
+}
+
+// exits with 1 on the first board whose metrics differ from the reference
+int main()
+{
+    // random sizes (thin boards and single rows/columns too) and densities
+    Random random(12345);
+    MetricsScratch scratch;
+    Board board;
+    board.setHeadless(true);
+    const uint32_t boards = 20000;
+    for (uint32_t i = 0; i < boards; ++i)
+    {
+        const uint32_t width = 1 + random.bounded(40);
+        const uint32_t height = 1 + random.bounded(40);
+        const uint32_t size = width * height;
+        if (size < 2)
+            continue;
+        const uint32_t mines = random.bounded(size);
+        const uint32_t firstClick = random.bounded(size);
+        // metrics read the board row by row, whatever its layout
+        board.setLayout(i % 2 == 0 ? TileLayoutKind::rowMajor : TileLayoutKind::blocked);
+        board.reset(width, height, mines);
+        board.generate(firstClick, i, random.bounded(2));
+
+        const BoardMetrics fast = computeMetrics(board, scratch);
+        const BoardMetrics reference = referenceMetrics(board);
+        if (!same(fast, reference))
+        {
+            std::cerr << "board " << i << " (" << width << "x" << height << ", " << mines << " mines): computeMetrics ";
+            print(fast);
+            std::cerr << ", reference ";
+            print(reference);
+            std::cerr << " (3BV/openings/isolated)\n";
+            return 1;
+        }
+    }
+
+    // batches on all cores give the same metrics as the boards made one by one
+    MetricsBatchConfig config;
+    config.boards = 1000;
+    config.seed = 77;
+    config.firstClick = config.height / 2 * config.width + config.width / 2;
+    config.batchSize = 64;
+    std::vector<BoardMetrics> batched(config.boards);
+    generateMetrics(config, [&](uint64_t first, const std::vector<BoardMetrics>& batch)
+    {
+        std::copy(batch.begin(), batch.end(), batched.begin() + first);
+    });
+    board.setLayout(TileLayoutKind::rowMajor);
+    for (uint64_t i = 0; i < config.boards; ++i)
+    {
+        board.reset(config.width, config.height, config.mines);
+        board.generate(config.firstClick, config.seed + i, config.safeRadius);
+        if (!same(batched[i], referenceMetrics(board)))
+        {
+            std::cerr << "batch board " << i << ": generateMetrics ";
+            print(batched[i]);
+            std::cerr << ", reference ";
+            print(referenceMetrics(board));
+            std::cerr << "\n";
+            return 1;
+        }
+    }
+
+    std::cout << boards << " random boards and " << config.boards << " batched boards match the reference\n";
+    return 0;
+}
@@ -0,0 +1,89 @@
+// SpscQueueTest.cpp
+// Checks SpscQueue: clear() with items still queued, wrap-around, and one producer/one consumer thread in order
+#include <SpscQueue.h>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+
+using namespace game;
+
+namespace
+{
+    bool check(bool condition, const char* what)
+    {
+        if (!condition)
+            std::cerr << "failed: " << what << "\n";
+        return condition;
+    }
+
+    // what Game does when a game ends with tile updates still queued: clear, then use the queue again
+    bool clearThenReuse()
+    {
+        SpscQueue<uint32_t> queue(8);
+        uint32_t item = 0;
+        // the consumer cached the tail on its pop, more items came after it and are left behind
+        queue.tryPush(0);
+        queue.tryPush(1);
+        if (!check(queue.tryPop(item) && item == 0, "first pop"))
+            return false;
+        for (uint32_t i = 2; i < 5; ++i)
+            queue.tryPush(i);
+        queue.clear();
+        if (!check(queue.empty(), "empty after clear") || !check(!queue.tryPop(item), "no pop after clear"))
+            return false;
+
+        // the queue is whole again: capacity items go in, come out in order
+        for (uint32_t i = 0; i < queue.capacity(); ++i)
+        {
+            if (!check(queue.tryPush(100 + i), "push after clear"))
+                return false;
+        }
+        if (!check(!queue.tryPush(0), "full after capacity pushes"))
+            return false;
+        for (uint32_t i = 0; i < queue.capacity(); ++i)
+        {
+            if (!check(queue.tryPop(item) && item == 100 + i, "pop after clear"))
+                return false;
+        }
+        return check(queue.empty() && !queue.tryPop(item), "empty at the end");
+    }
+
+    // a small ring goes around many times, items arrive once each, in order
+    bool threads()
+    {
+        const uint32_t items = 1000000;
+        SpscQueue<uint32_t> queue(64);
+        std::thread producer([&]()
+        {
+            for (uint32_t i = 0; i < items; ++i)
+            {
+                while (!queue.tryPush(i))
+                    std::this_thread::yield();
+            }
+        });
+        uint32_t expected = 0;
+        bool ordered = true;
+        while (expected < items)
+        {
+            uint32_t item = 0;
+            if (!queue.tryPop(item))
+            {
+                std::this_thread::yield();
+                continue;
+            }
+            ordered = ordered && item == expected;
+            expected++;
+        }
+        producer.join();
+        return check(ordered, "items in push order") && check(queue.empty(), "empty after the threads");
+    }
+}
+
+// exits with 1 if a check fails
+int main()
+{
+    if (!clearThenReuse() || !threads())
+        return 1;
+    std::cout << "SpscQueue checks passed\n";
+    return 0;
+}